@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string_view>
+
+// timing for the cpu benchmarks: a case is called in batches that double until one takes long enough to time, and
+// the best of a few such batches is kept, per call
+namespace surge::bench
+{
+
+// keeps a result alive, so that the work producing it is not optimized away
+template<typename T>
+void keep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// nanoseconds per call of f
+template<typename F>
+double measure(F&& f, const double minimum = 0.05, const int runs = 5)
+{
+    double best = std::numeric_limits<double>::infinity();
+    for (int run = 0; run < runs; ++run)
+    {
+        for (long calls = 1;; calls *= 2)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for (long i = 0; i < calls; ++i)
+            {
+                f();
+            }
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (elapsed >= minimum)
+            {
+                best = std::min(best, 1e9 * elapsed / static_cast<double>(calls));
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+// one line per case: its name, the time per call and, for batched cases, the time per item
+inline void report(const std::string_view name, const double nanoseconds, const double items = 1)
+{
+    std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << nanoseconds << " ns";
+    if (items != 1)
+    {
+        std::cout << std::setw(12) << nanoseconds / items << " ns/item";
+    }
+    std::cout << std::endl;
+}
+
+}  // namespace surge::bench
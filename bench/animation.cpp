@@ -0,0 +1,93 @@
+// playback of long clips, thousands of keys per sampler: the cached per-sampler cursors of Animation against a binary
+// search of every sampler each frame, which the cursors replaced
+
+#include "Benchmark.hpp"
+
+#include "surge/asset/Animation.hpp"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace surge;
+using namespace surge::asset;
+
+namespace
+{
+
+constexpr std::size_t channelCount { 120 };
+constexpr std::size_t samplerCount { 40 };
+constexpr float       keyRate { 30 };  // keys per second
+constexpr double      frameTime { 1.0 / 60 };
+
+// translation, rotation and scale channels over shared linear samplers
+Animation createAnimation(const std::size_t keyCount)
+{
+    Animation animation;
+    animation.start = 0;
+    animation.end   = static_cast<float>(keyCount - 1) / keyRate;
+    for (std::size_t s = 0; s < samplerCount; ++s)
+    {
+        Animation::Sampler sampler { Animation::Sampler::Interpolation::linear, {}, {}, std::nullopt };
+        for (std::size_t k = 0; k < keyCount; ++k)
+        {
+            const auto angle = 0.01f * static_cast<float>(k + s);
+            sampler.inputs.push_back(static_cast<float>(k) / keyRate);
+            sampler.outputs.push_back({ std::sin(angle), 0, 0, std::cos(angle) });
+        }
+        animation.samplers.push_back(std::move(sampler));
+    }
+    constexpr std::array paths { Animation::Channel::Path::translation, Animation::Channel::Path::rotation,
+                                 Animation::Channel::Path::scale };
+    for (std::size_t c = 0; c < channelCount; ++c)
+    {
+        animation.channels.push_back({ paths[c % 3], static_cast<uint32_t>(c / 3),
+                                       static_cast<uint32_t>(c % samplerCount) });
+    }
+    return animation;
+}
+
+Pose createPose()
+{
+    Pose pose;
+    pose.translations.resize(channelCount / 3, { 0, 0, 0 });
+    pose.rotations.resize(channelCount / 3, { 0, 0, 0, 1 });
+    pose.scales.resize(channelCount / 3, { 1, 1, 1 });
+    pose.weights.resize(channelCount / 3);
+    return pose;
+}
+
+}  // namespace
+
+int main()
+{
+    for (const std::size_t keyCount : { 100ul, 1000ul, 10000ul, 100000ul })
+    {
+        const auto animation = createAnimation(keyCount);
+        auto       pose      = createPose();
+
+        // a frame of playback: the cursors step forward from where the previous frame left them
+        const auto cursor = [&]
+        {
+            animation.advance(frameTime);
+            animation.sample(pose);
+            bench::keep(pose.rotations.front());
+        };
+
+        // the same frames, with every sampler searched from scratch
+        Animation::State sampling;
+        float            time { 0 };
+        const auto       search = [&]
+        {
+            time = std::fmod(time + static_cast<float>(frameTime), animation.end);
+            sampling.cursors.assign(animation.samplers.size(), std::numeric_limits<std::size_t>::max());
+            animation.sampleAt(time, sampling, pose);
+            bench::keep(pose.rotations.front());
+        };
+
+        const auto keys = std::to_string(keyCount) + " keys";
+        bench::report("cursor, " + keys, bench::measure(cursor));
+        bench::report("binary search, " + keys, bench::measure(search));
+    }
+}
@@ -0,0 +1,205 @@
+// the structure of arrays kernels of math::batch against the loops they replace over arrays of structures, for
+// batches of 1k to 1M points, normals, boxes and spheres
+
+#include "Benchmark.hpp"
+
+#include "surge/math/batch.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace surge;
+using namespace surge::math;
+
+namespace
+{
+
+std::mt19937                          generator { 5 };
+std::uniform_real_distribution<float> uniform { -2, 2 };
+std::uniform_real_distribution<float> scale { 0.5f, 2 };
+std::uniform_real_distribution<float> world { -30, 30 };
+
+Affine<> randomAffine()
+{
+    return affine(Translation<> { { uniform(generator), uniform(generator), uniform(generator) } },
+                  Rotation<> { normalize(Quaternion<> { uniform(generator), uniform(generator), uniform(generator),
+                                                        uniform(generator) }) },
+                  Scaling<> { { scale(generator), scale(generator), scale(generator) } });
+}
+
+Vector<3> randomPoint()
+{
+    return { uniform(generator), uniform(generator), uniform(generator) };
+}
+
+// the kernels against the same arithmetic on arrays of structures
+void run(const Size size, const batch::Frustum& frustum)
+{
+    const auto m = randomAffine();
+
+    std::vector<Vector<3>>   points(size);
+    std::vector<BoundingBox> boxes(size);
+    std::vector<Affine<>>    matrices(size);
+    std::vector<Vector<4>>   spheres(size);  // center, radius
+    batch::Points            batchPoints;
+    batch::Boxes             batchBoxes;
+    batch::Spheres           batchSpheres;
+    for (Size i = 0; i < size; ++i)
+    {
+        points[i] = randomPoint();
+        batchPoints.push_back(points[i]);
+        const auto min = randomPoint();
+        boxes[i]       = { min, { min[0] + 1, min[1] + 1, min[2] + 1 } };
+        batchBoxes.push_back(boxes[i]);
+        matrices[i] = randomAffine();
+        spheres[i]  = { world(generator), world(generator), world(generator), scale(generator) };
+        batchSpheres.push_back({ spheres[i][0], spheres[i][1], spheres[i][2] }, spheres[i][3]);
+    }
+
+    std::vector<Vector<3>>   outPoints(size);
+    std::vector<BoundingBox> outBoxes(size);
+    std::vector<uint8_t>     visible(size);
+    batch::Points            batchOutPoints;
+    batch::Boxes             batchOutBoxes;
+    std::vector<uint8_t>     batchVisible;
+
+    const auto pointsBatch = [&]
+    {
+        batch::transformPoints(m, batchPoints, batchOutPoints);
+        bench::keep(batchOutPoints.x.back());
+    };
+    const auto pointsAos = [&]
+    {
+        for (Size i = 0; i < size; ++i)
+        {
+            const auto& p = points[i];
+            for (Size r = 0; r < 3; ++r)
+            {
+                outPoints[i][r] = m[4 * r] * p[0] + m[4 * r + 1] * p[1] + m[4 * r + 2] * p[2] + m[4 * r + 3];
+            }
+        }
+        bench::keep(outPoints.back());
+    };
+
+    const auto normalsBatch = [&]
+    {
+        batch::transformNormals(m, batchPoints, batchOutPoints);
+        bench::keep(batchOutPoints.x.back());
+    };
+    const auto normalsAos = [&]
+    {
+        const auto inv = inverse(m);
+        for (Size i = 0; i < size; ++i)
+        {
+            const auto& p = points[i];
+            Vector<3>   n;
+            for (Size r = 0; r < 3; ++r)
+            {
+                n[r] = inv[r] * p[0] + inv[4 + r] * p[1] + inv[8 + r] * p[2];
+            }
+            outPoints[i] = normalize(n);
+        }
+        bench::keep(outPoints.back());
+    };
+
+    const auto boxesBatch = [&]
+    {
+        batch::transformBoxes(matrices, batchBoxes, batchOutBoxes);
+        bench::keep(batchOutBoxes.max.x.back());
+    };
+    const auto boxesAos = [&]
+    {
+        for (Size i = 0; i < size; ++i)
+        {
+            const auto& a   = matrices[i];
+            const auto& box = boxes[i];
+            for (Size r = 0; r < 3; ++r)
+            {
+                float center = a[4 * r + 3];
+                float extent = 0;
+                for (Size k = 0; k < 3; ++k)
+                {
+                    center += a[4 * r + k] * 0.5f * (box.min[k] + box.max[k]);
+                    extent += std::abs(a[4 * r + k]) * 0.5f * (box.max[k] - box.min[k]);
+                }
+                outBoxes[i].min[r] = center - extent;
+                outBoxes[i].max[r] = center + extent;
+            }
+        }
+        bench::keep(outBoxes.back());
+    };
+
+    const auto spheresBatch = [&]
+    {
+        batch::intersect(frustum, batchSpheres, batchVisible);
+        bench::keep(batchVisible.back());
+    };
+    const auto spheresAos = [&]
+    {
+        for (Size i = 0; i < size; ++i)
+        {
+            const auto& s      = spheres[i];
+            bool        inside = true;
+            for (const auto& [normal, distance] : frustum)
+            {
+                inside = inside && normal[0] * s[0] + normal[1] * s[1] + normal[2] * s[2] + distance >= -s[3];
+            }
+            visible[i] = inside;
+        }
+        bench::keep(visible.back());
+    };
+
+    const auto items  = static_cast<double>(size);
+    const auto report = [&](const char* kernel, const auto& f)
+    { bench::report(std::string { kernel } + " " + std::to_string(size), bench::measure(f), items); };
+    report("points batch", pointsBatch);
+    report("points aos", pointsAos);
+    report("normals batch", normalsBatch);
+    report("normals aos", normalsAos);
+    report("boxes batch", boxesBatch);
+    report("boxes aos", boxesAos);
+    report("spheres batch", spheresBatch);
+    report("spheres aos", spheresAos);
+}
+
+}  // namespace
+
+int main()
+{
+    const Matrix<4, 4> viewProjection =
+        Perspective<true>(1.0f, 1.5f, 0.1f, 50.0f) * View<>({ 3, 2, 5 }, { 0, 0, 0 }, { 0, 1, 0 });
+    const auto frustum = batch::frustum(viewProjection);
+
+    // points inside the clip volume are the spheres of radius 0 found visible
+    batch::Spheres points;
+    for (Size i = 0; i < 100003; ++i)
+    {
+        points.push_back({ world(generator), world(generator), world(generator) }, 0);
+    }
+    std::vector<uint8_t> visible;
+    batch::intersect(frustum, points, visible);
+    Size mismatches { 0 };
+    for (Size i = 0; i < points.size(); ++i)
+    {
+        const auto c = points.center[i];
+        float      clip[4];
+        for (Size r = 0; r < 4; ++r)
+        {
+            clip[r] = viewProjection[4 * r] * c[0] + viewProjection[4 * r + 1] * c[1] +
+                      viewProjection[4 * r + 2] * c[2] + viewProjection[4 * r + 3];
+        }
+        const bool inside = clip[3] > 0 && std::abs(clip[0]) <= clip[3] && std::abs(clip[1]) <= clip[3] &&
+                            clip[2] >= 0 && clip[2] <= clip[3];
+        mismatches += inside != (visible[i] != 0);
+    }
+    std::cout << "backend " << simd::backend << ", frustum mismatches " << mismatches << " of " << points.size()
+              << std::endl;
+
+    for (const Size size : { 1000ul, 10000ul, 100000ul, 1000000ul })
+    {
+        run(size, frustum);
+    }
+}
@@ -0,0 +1,107 @@
+// an asset loaded cold, with its cache removed, then warm from the cache the cold load baked, through a device like
+// the application loads it, so a window is opened; usage: bench/load <asset.gltf> [runs]
+
+#include "Benchmark.hpp"
+
+#include "surge/Command.hpp"
+#include "surge/Context.hpp"
+#include "surge/Defaults.hpp"
+#include "surge/UserInteraction.hpp"
+#include "surge/asset/Asset.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace surge;
+
+namespace
+{
+
+// seconds of the whole load, the rest is the breakdown the importer keeps
+struct Load
+{
+    double                seconds;
+    asset::LoadStatistics statistics;
+};
+
+Load load(const Command& command, const Defaults& defaults, const std::filesystem::path& path, const bool cold)
+{
+    if (cold)
+    {
+        std::filesystem::remove(path.string() + ".cache");
+    }
+    const auto         start = std::chrono::steady_clock::now();
+    const asset::Asset asset { command, defaults, asset::GltfAsset { path.stem().string(), path } };
+    const auto         seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (asset.loadStatistics.cached == cold)
+    {
+        throw std::runtime_error(cold ? "cold load found a cache" : "warm load missed the cache");
+    }
+    return { seconds, asset.loadStatistics };
+}
+
+void report(const std::string& name, const Load& load)
+{
+    const auto& s = load.statistics;
+    bench::report(name + " total", 1e9 * load.seconds);
+    bench::report(name + " document", 1e9 * s.seconds);
+    bench::report(name + " hash", 1e9 * s.hashSeconds);
+    bench::report(name + " textures", 1e9 * s.textureSeconds);
+    bench::report(name + " model", 1e9 * s.modelSeconds);
+    std::cout << name << " mapped " << s.mappedBytes << " bytes, copied " << s.copiedBytes << " bytes, peak resident "
+              << s.peakResidentBytes << " bytes" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <asset.gltf> [runs]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path path { argv[1] };
+    const int                   runs = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    try
+    {
+        UserInteraction userInteraction { 320, 180 };
+        createContext("surge-bench", "surge", 320, 180, &userInteraction);
+        const Command  command {};
+        const Defaults defaults { command, { { "root", SURGE_TEXTURES }, { "shaders", SURGE_SHADERS } } };
+
+        // alternating, so that both see the same state of the file system cache; the fastest run of each is kept
+        std::optional<Load> cold;
+        std::optional<Load> warm;
+        for (int run = 0; run < runs; ++run)
+        {
+            for (const bool isCold : { true, false })
+            {
+                auto  next = load(command, defaults, path, isCold);
+                auto& best = isCold ? cold : warm;
+                if (!best || next.seconds < best->seconds)
+                {
+                    best = next;
+                }
+            }
+        }
+        report("cold", cold.value());
+        report("warm", warm.value());
+
+        const std::scoped_lock lock { context().queueMutexes[0], context().queueMutexes[1] };
+        vkDeviceWaitIdle(context().device);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
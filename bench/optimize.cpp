@@ -0,0 +1,143 @@
+// the import-time reordering of geometry/optimize.hpp on a 100x100 grid of shuffled triangles: the average cache miss
+// ratio and the average transformed to vertex ratio after every pass, then the time each pass takes
+
+#include "Benchmark.hpp"
+
+// the vertex formats are vulkan's, and Vertex.hpp includes nothing itself
+#include <vulkan/vulkan.h>
+
+#include "surge/geometry/optimize.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace surge;
+
+namespace
+{
+
+constexpr UInt32 gridSize { 100 };  // quads per side
+
+struct Grid
+{
+    std::vector<math::Vector<3>> positions;
+    std::vector<geometry::Index> indices;
+};
+
+// a bowl, so that overdraw has depth to sort on, with its triangles in random order
+Grid createGrid()
+{
+    Grid grid;
+    for (UInt32 y = 0; y <= gridSize; ++y)
+    {
+        for (UInt32 x = 0; x <= gridSize; ++x)
+        {
+            const auto dx = static_cast<float>(x) - 0.5f * gridSize;
+            const auto dy = static_cast<float>(y) - 0.5f * gridSize;
+            grid.positions.push_back({ static_cast<float>(x), static_cast<float>(y), 0.01f * (dx * dx + dy * dy) });
+        }
+    }
+
+    std::vector<std::array<geometry::Index, 3>> triangles;
+    for (UInt32 y = 0; y < gridSize; ++y)
+    {
+        for (UInt32 x = 0; x < gridSize; ++x)
+        {
+            const auto a = y * (gridSize + 1) + x;
+            const auto b = a + 1;
+            const auto c = a + gridSize + 1;
+            const auto d = c + 1;
+            triangles.push_back({ a, b, c });
+            triangles.push_back({ b, d, c });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937 { 1 });
+    for (const auto& triangle : triangles)
+    {
+        grid.indices.insert(grid.indices.end(), triangle.begin(), triangle.end());
+    }
+    return grid;
+}
+
+// the triangles as a sorted set, each rotated to start at its smallest index, to check that no pass loses one
+std::vector<std::array<geometry::Index, 3>> triangleSet(const std::vector<geometry::Index>& indices)
+{
+    std::vector<std::array<geometry::Index, 3>> set;
+    for (Size i = 0; i < indices.size(); i += 3)
+    {
+        std::array<geometry::Index, 3> triangle { indices[i], indices[i + 1], indices[i + 2] };
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        set.push_back(triangle);
+    }
+    std::sort(set.begin(), set.end());
+    return set;
+}
+
+void print(const char* pass, const geometry::CacheStatistics& statistics)
+{
+    std::cout << std::left << std::setw(16) << pass << std::right << std::fixed << std::setprecision(3) << "acmr "
+              << statistics.acmr() << "  atvr " << statistics.atvr() << std::endl;
+}
+
+}  // namespace
+
+int main()
+{
+    const auto source      = createGrid();
+    const auto vertexCount = source.positions.size();
+
+    auto grid = source;
+    print("shuffled", geometry::analyzeVertexCache(grid.indices, vertexCount));
+    geometry::optimizeVertexCache(grid.indices, vertexCount);
+    print("vertex cache", geometry::analyzeVertexCache(grid.indices, vertexCount));
+    geometry::optimizeOverdraw(grid.indices, grid.positions);
+    print("overdraw", geometry::analyzeVertexCache(grid.indices, vertexCount));
+    const auto reordered = grid;
+    geometry::optimizeVertexFetch(std::span { grid.indices }, std::span { grid.positions });
+    print("vertex fetch", geometry::analyzeVertexCache(grid.indices, vertexCount));
+
+    // the triangle passes only reorder triangles, the fetch pass only renumbers vertices
+    bool kept = triangleSet(reordered.indices) == triangleSet(source.indices);
+    for (Size i = 0; i < grid.indices.size(); ++i)
+    {
+        kept = kept && grid.positions[grid.indices[i]] == reordered.positions[reordered.indices[i]];
+    }
+    if (!kept)
+    {
+        std::cerr << "the passes lost or changed triangles" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // every pass from the output of the previous one, on a copy
+    const auto vertexCache = [&]
+    {
+        auto indices = source.indices;
+        geometry::optimizeVertexCache(indices, vertexCount);
+        bench::keep(indices.front());
+    };
+    auto input = source;
+    geometry::optimizeVertexCache(input.indices, vertexCount);
+    const auto overdraw = [&]
+    {
+        auto indices = input.indices;
+        geometry::optimizeOverdraw(indices, input.positions);
+        bench::keep(indices.front());
+    };
+    const auto vertexFetch = [&]
+    {
+        auto indices   = reordered.indices;
+        auto positions = reordered.positions;
+        geometry::optimizeVertexFetch(std::span { indices }, std::span { positions });
+        bench::keep(indices.front());
+    };
+
+    const auto triangles = static_cast<double>(source.indices.size() / 3);
+    bench::report("vertex cache", bench::measure(vertexCache), triangles);
+    bench::report("overdraw", bench::measure(overdraw), triangles);
+    bench::report("vertex fetch", bench::measure(vertexFetch), triangles);
+}
@@ -0,0 +1,114 @@
+// products of structured matrices, which keep their zero pattern, against the same products of dense matrices; every
+// case is a noinline function, so that its listing can be read back from the binary, e.g.
+// objdump -d --no-show-raw-insn -C bench/products | less
+
+#include "Benchmark.hpp"
+
+#include "surge/math/matrices.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace surge;
+using namespace surge::math;
+
+namespace
+{
+
+[[gnu::noinline]] Matrix<4, 4> trsStructured(const Translation<>& t, const Rotation<>& r, const Scaling<>& s)
+{
+    return t * r * s;
+}
+
+[[gnu::noinline]] Matrix<4, 4> trsDense(const Translation<>& t, const Rotation<>& r, const Scaling<>& s)
+{
+    return fullMatrix(t) * fullMatrix(r) * fullMatrix(s);
+}
+
+[[gnu::noinline]] Matrix<4, 4> trsGeneric(const Translation<>& t, const Rotation<>& r, const Scaling<>& s)
+{
+    using M = Matrix<4, 4>;
+    return operator*<M, M>(operator*<M, M>(fullMatrix(t), fullMatrix(r)), fullMatrix(s));
+}
+
+[[gnu::noinline]] Affine<> trsAffine(const Translation<>& t, const Rotation<>& r, const Scaling<>& s)
+{
+    return affine(t * r * s);
+}
+
+[[gnu::noinline]] Matrix<4, 4> pvStructured(const Perspective<true>& p, const View<>& v)
+{
+    return p * v;
+}
+
+[[gnu::noinline]] Matrix<4, 4> pvDense(const Perspective<true>& p, const View<>& v)
+{
+    return fullMatrix(p) * fullMatrix(v);
+}
+
+float difference(const Matrix<4, 4>& a, const Matrix<4, 4>& b)
+{
+    float d { 0 };
+    for (Size i = 0; i < 16; ++i)
+    {
+        d = std::max(d, std::abs(a[i] - b[i]));
+    }
+    return d;
+}
+
+}  // namespace
+
+int main()
+{
+    std::cout << "multiplications: T R " << productCost<Translation<>, Rotation<>> << ", (T R) S "
+              << productCost<decltype(Translation<> {} * Rotation<> {}), Scaling<>> << ", P V "
+              << productCost<Perspective<true>, View<>> << ", dense 64" << std::endl;
+
+    std::mt19937                          generator { 3 };
+    std::uniform_real_distribution<float> uniform { -2, 2 };
+    std::uniform_real_distribution<float> scale { 0.5f, 2 };
+
+    std::vector<std::tuple<Translation<>, Rotation<>, Scaling<>>> transforms;
+    for (Size i = 0; i < 1024; ++i)
+    {
+        transforms.emplace_back(
+            Translation<> { { uniform(generator), uniform(generator), uniform(generator) } },
+            Rotation<> { normalize(
+                Quaternion<> { uniform(generator), uniform(generator), uniform(generator), uniform(generator) }) },
+            Scaling<> { { scale(generator), scale(generator), scale(generator) } });
+    }
+    const Perspective<true> p { 1.0f, 1.5f, 0.1f, 50.0f };
+    const View<>            v { { 3, 2, 5 }, { 0, 0, 0 }, { 0, 1, 0 } };
+
+    // the structured products drop terms that are exactly zero, so they agree with the dense ones
+    float error { difference(pvStructured(p, v), pvDense(p, v)) };
+    for (const auto& [t, r, s] : transforms)
+    {
+        const auto dense = trsDense(t, r, s);
+        error            = std::max({ error, difference(trsStructured(t, r, s), dense),
+                                      difference(trsGeneric(t, r, s), dense),
+                                      difference(fullMatrix(trsAffine(t, r, s)), dense) });
+    }
+    std::cout << "largest difference " << error << std::endl;
+
+    const auto trs = [&](const auto f)
+    {
+        return [&transforms, f]
+        {
+            for (const auto& [t, r, s] : transforms)
+            {
+                bench::keep(f(t, r, s));
+            }
+        };
+    };
+    const auto items = static_cast<double>(transforms.size());
+    bench::report("T R S structured", bench::measure(trs(trsStructured)), items);
+    bench::report("T R S dense, simd", bench::measure(trs(trsDense)), items);
+    bench::report("T R S dense, generic", bench::measure(trs(trsGeneric)), items);
+    bench::report("T R S to affine", bench::measure(trs(trsAffine)), items);
+    bench::report("P V structured", bench::measure([&] { bench::keep(pvStructured(p, v)); }));
+    bench::report("P V dense, simd", bench::measure([&] { bench::keep(pvDense(p, v)); }));
+}
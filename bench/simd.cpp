@@ -0,0 +1,138 @@
+// the 4x4 matrix and 4-vector hot paths through the simd backend, the generic templates they replace, and glm; build
+// the simd_scalar target as well to time the scalar fallback of the backend
+
+#include "Benchmark.hpp"
+
+#include "surge/math/Matrix.hpp"
+#include "surge/math/Vector.hpp"
+
+#include "glm/glm.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace surge;
+using namespace surge::math;
+
+namespace
+{
+
+constexpr Size count { 1024 };
+
+// glm is column major: the same memory read as glm is the transpose, so glm multiplies its operands the other way
+// round to give the same product
+glm::mat4 toGlm(const Matrix<4, 4>& m)
+{
+    glm::mat4 g;
+    std::memcpy(&g, m.data(), sizeof(g));
+    return g;
+}
+
+float difference(const float* a, const float* b, const Size size)
+{
+    float d { 0 };
+    for (Size i = 0; i < size; ++i)
+    {
+        d = std::max(d, std::abs(a[i] - b[i]) / (1 + std::abs(b[i])));
+    }
+    return d;
+}
+
+}  // namespace
+
+int main()
+{
+    std::mt19937                          random { 1 };
+    std::uniform_real_distribution<float> uniform { -2, 2 };
+
+    std::vector<Matrix<4, 4>> matrices(count);
+    std::vector<Vector<4>>    vectors(count);
+    for (auto& m : matrices)
+    {
+        std::ranges::generate(m, [&] { return uniform(random); });
+    }
+    for (auto& v : vectors)
+    {
+        std::ranges::generate(v, [&] { return uniform(random); });
+    }
+    std::vector<glm::mat4> glmMatrices(count);
+    std::vector<glm::vec4> glmVectors(count);
+    for (Size i = 0; i < count; ++i)
+    {
+        glmMatrices[i] = toGlm(matrices[i]);
+        std::memcpy(&glmVectors[i], vectors[i].data(), sizeof(glm::vec4));
+    }
+
+    // the three agree before they are timed
+    float multiplyError { 0 };
+    float inverseError { 0 };
+    for (Size i = 0; i + 1 < count; ++i)
+    {
+        const auto c         = matrices[i] * matrices[i + 1];
+        const auto generic   = operator*<Matrix<4, 4>, Matrix<4, 4>>(matrices[i], matrices[i + 1]);
+        const auto reference = glmMatrices[i + 1] * glmMatrices[i];
+        multiplyError        = std::max({ multiplyError, difference(c.data(), generic.data(), 16),
+                                          difference(c.data(), &reference[0][0], 16) });
+
+        const auto inv        = inverse(matrices[i]);
+        const auto genericInv = inverse<Matrix<4, 4>>(matrices[i]);
+        const auto glmInv     = glm::inverse(glmMatrices[i]);
+        inverseError          = std::max({ inverseError, difference(inv.data(), genericInv.data(), 16),
+                                           difference(inv.data(), &glmInv[0][0], 16) });
+    }
+    std::cout << "backend " << simd::backend << ", largest relative difference: multiply " << multiplyError
+              << ", inverse " << inverseError << std::endl;
+
+    // every case walks the same 1024 operands, per call
+    const auto run = [](const auto& operands, const auto& f)
+    {
+        return [&operands, f]
+        {
+            for (Size i = 0; i + 1 < count; ++i)
+            {
+                bench::keep(f(operands[i], operands[i + 1]));
+            }
+        };
+    };
+    constexpr auto pairs = static_cast<double>(count - 1);
+
+    bench::report("multiply simd", bench::measure(run(matrices, [](const auto& a, const auto& b) { return a * b; })),
+                  pairs);
+    bench::report("multiply generic",
+                  bench::measure(run(matrices, [](const auto& a, const auto& b)
+                                     { return operator*<Matrix<4, 4>, Matrix<4, 4>>(a, b); })),
+                  pairs);
+    bench::report("multiply glm",
+                  bench::measure(run(glmMatrices, [](const auto& a, const auto& b) { return b * a; })), pairs);
+
+    bench::report("inverse simd", bench::measure(run(matrices, [](const auto& a, const auto&) { return inverse(a); })),
+                  pairs);
+    bench::report("inverse generic",
+                  bench::measure(
+                      run(matrices, [](const auto& a, const auto&) { return inverse<Matrix<4, 4>>(a); })),
+                  pairs);
+    bench::report("inverse glm",
+                  bench::measure(run(glmMatrices, [](const auto& a, const auto&) { return glm::inverse(a); })),
+                  pairs);
+
+    bench::report("dot simd", bench::measure(run(vectors, [](const auto& a, const auto& b) { return dot(a, b); })),
+                  pairs);
+    bench::report("dot generic",
+                  bench::measure(run(vectors, [](const auto& a, const auto& b) { return dot<Vector<4>>(a, b); })),
+                  pairs);
+    bench::report("dot glm",
+                  bench::measure(run(glmVectors, [](const auto& a, const auto& b) { return glm::dot(a, b); })),
+                  pairs);
+
+    bench::report("normalize simd",
+                  bench::measure(run(vectors, [](const auto& a, const auto&) { return normalize(a); })), pairs);
+    bench::report("normalize generic",
+                  bench::measure(run(vectors, [](const auto& a, const auto&) { return normalize<Vector<4>>(a); })),
+                  pairs);
+    bench::report("normalize glm",
+                  bench::measure(run(glmVectors, [](const auto& a, const auto&) { return glm::normalize(a); })),
+                  pairs);
+}
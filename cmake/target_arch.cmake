@@ -0,0 +1,15 @@
+# the simd math backend follows the target instruction set, see include/surge/math/simd.hpp: x86-64 builds ask for
+# SSE4.1, part of the x86-64-v2 baseline, and SURGE_NATIVE_ARCH builds for the host instead, FMA included when it has
+# it; other targets keep their default
+option(SURGE_NATIVE_ARCH "Build for the instruction set of the host" OFF)
+
+function (target_arch target)
+    if (MSVC)
+        return()
+    endif()
+    if (SURGE_NATIVE_ARCH)
+        target_compile_options(${target} PRIVATE -march=native)
+    elseif (CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64)$")
+        target_compile_options(${target} PRIVATE -msse4.1)
+    endif()
+endfunction()
@@ -246,7 +246,7 @@ public:
         const std::array<VkBuffer, 1>     vertexBuffers { sceneModel.vertexBuffer.buffer };
         const std::array<VkDeviceSize, 1> offsets { 0 };
         vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers.data(), offsets.data());
-        vkCmdBindIndexBuffer(commandBuffer, sceneModel.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdBindIndexBuffer(commandBuffer, sceneModel.indexBuffer.buffer, 0, sceneModel.indexType);
 
         vkCmdDrawIndexed(commandBuffer, sceneModel.indexCount, 1, 0, 0, 0);
 
@@ -314,7 +314,7 @@ public:
             const std::array<VkBuffer, 1>     vertexBuffers { sceneModel.vertexBuffer.buffer };
             const std::array<VkDeviceSize, 1> offsets { 0 };
             vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers.data(), offsets.data());
-            vkCmdBindIndexBuffer(commandBuffer, sceneModel.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdBindIndexBuffer(commandBuffer, sceneModel.indexBuffer.buffer, 0, sceneModel.indexType);
 
             vkCmdDrawIndexed(commandBuffer, sceneModel.indexCount, 1, 0, 0, 0);
         }
@@ -82,7 +82,7 @@ public:
 
         constexpr std::array<VkDeviceSize, 1> offsets { 0 };
         vkCmdBindVertexBuffers(commandBuffer, 0, 1, &model.vertexBuffer.buffer, offsets.data());
-        vkCmdBindIndexBuffer(commandBuffer, model.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdBindIndexBuffer(commandBuffer, model.indexBuffer.buffer, 0, model.indexType);
 
         const VkViewport viewport {
             .x        = 0.0f,
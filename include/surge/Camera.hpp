@@ -21,11 +21,12 @@ public:
         : sensitivity { 0.1f }
         , speed { 2.5f }
         , aspect { aspect }
+        , fovy { math::deg2rad(45.0f) }
         , yaw { -90.0f }
         , pitch { 0.0f }
         , vecs { .position = position, .front = front, .up = { 0, 1, 0 }, }
         , mats {
-            .perspective = { math::deg2rad(45.0f), aspect, 0.1f, 1024.0f },
+            .perspective = { fovy, aspect, 0.1f, 1024.0f },
             .view        = { vecs.position, vecs.position + vecs.front, vecs.up },
         }
     {
@@ -34,6 +35,7 @@ public:
     float sensitivity;
     float speed;
     float aspect;
+    float fovy;
     float yaw;
     float pitch;
 
@@ -55,7 +57,7 @@ public:
         if (ui.framebufferResized)
         {
             aspect           = static_cast<float>(ui.width) / ui.height;
-            mats.perspective = math::Perspective<flipY> { math::deg2rad(45.0f), aspect, 0.1f, 100.0f };
+            mats.perspective = math::Perspective<flipY> { fovy, aspect, 0.1f, 100.0f };
         }
 
         if (!ui.mouseActive)
@@ -4,6 +4,8 @@
 #include "surge/Buffer.hpp"
 
 #include <array>
+#include <limits>
+#include <mutex>
 
 namespace surge
 {
@@ -18,8 +20,10 @@ namespace detail
 class Command
 {
 public:
-    Command()
-        : graphicsQueue { getQueue(context().physicalDevice.graphicsFamilyIndex) }
+    // queueIndex selects among the queues of the graphics family; the first one is the render loop's
+    explicit Command(const uint32_t queueIndex = 0)
+        : queueIndex { queueIndex }
+        , graphicsQueue { getQueue(context().physicalDevice.graphicsFamilyIndex, queueIndex) }
         , presentQueue { getQueue(context().physicalDevice.presentFamilyIndex) }
         , pool { createCommandPool() }
     {
@@ -64,8 +68,18 @@ public:
             .signalSemaphoreCount = 0,
             .pSignalSemaphores    = nullptr,
         };
-        vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(graphicsQueue);
+        // waits for this submission only, so that uploads from another thread do not stall on the frames in flight
+        const auto fence = context().create(VkFenceCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = {},
+        });
+        {
+            const std::lock_guard lock { context().queueMutexes.at(queueIndex) };
+            vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence);
+        }
+        vkWaitForFences(context().device, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+        context().destroy(fence);
 
         vkFreeCommandBuffers(context().device, pool, 1, &commandBuffer);
     }
@@ -188,8 +202,9 @@ public:
     }
 
 public:
-    VkQueue graphicsQueue;
-    VkQueue presentQueue;
+    uint32_t queueIndex;
+    VkQueue  graphicsQueue;
+    VkQueue  presentQueue;
 
 private:
     VkCommandPool pool;
@@ -198,10 +213,10 @@ public:
     VkRenderingAttachmentInfoKHR renderingAttachment;
 
 private:
-    VkQueue getQueue(const uint32_t index)
+    VkQueue getQueue(const uint32_t family, const uint32_t index = 0)
     {
         VkQueue queue;
-        vkGetDeviceQueue(context().device, index, 0, &queue);
+        vkGetDeviceQueue(context().device, family, index, &queue);
         return queue;
     }
 
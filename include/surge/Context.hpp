@@ -14,6 +14,7 @@
 #include <filesystem>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <optional>
 // #include <print>
 #include <set>
@@ -60,7 +61,7 @@ public:
         , surface { window.createSurface(instance) }
         , physicalDevice { pickPhysicalDevice(instance, surface) }
         , device { createLogicalDevice(physicalDevice.physicalDevice, physicalDevice.graphicsFamilyIndex,
-                                       physicalDevice.presentFamilyIndex) }
+                                       physicalDevice.graphicsQueueCount, physicalDevice.presentFamilyIndex) }
 #ifndef NDEBUG
         , debugMessenger { createDebugMessenger(instance) }
 #endif
@@ -194,6 +195,10 @@ public:
         {
             return construct<VkPipelineLayout>(vkCreatePipelineLayout, createInfo, allocator);
         }
+        else if constexpr (std::is_same_v<CreateInfo, VkQueryPoolCreateInfo>)
+        {
+            return construct<VkQueryPool>(vkCreateQueryPool, createInfo, allocator);
+        }
         else if constexpr (std::is_same_v<CreateInfo, VkRenderPassCreateInfo>)
         {
             return construct<VkRenderPass>(vkCreateRenderPass, createInfo, allocator);
@@ -271,6 +276,10 @@ public:
         {
             vkDestroyPipelineLayout(device, type, allocator);
         }
+        else if constexpr (std::is_same_v<Type, VkQueryPool>)
+        {
+            vkDestroyQueryPool(device, type, allocator);
+        }
         else if constexpr (std::is_same_v<Type, VkRenderPass>)
         {
             vkDestroyRenderPass(device, type, allocator);
@@ -316,7 +325,9 @@ public:
     struct PhysicalDevice
     {
         float              maxSamplerAnisotropy;
+        float              timestampPeriod;
         uint32_t           graphicsFamilyIndex;
+        uint32_t           graphicsQueueCount;  // the render loop's queue, and one for streaming uploads if available
         uint32_t           presentFamilyIndex;
         VkSurfaceFormatKHR surfaceFormat;
         VkPresentModeKHR   presentMode;
@@ -324,6 +335,10 @@ public:
     } physicalDevice;
     VkDevice device;
 
+    // external synchronization of the graphics queues: uploads from other threads submit to the second one when the
+    // device offers it, and share the first one with the render loop otherwise
+    mutable std::array<std::mutex, 2> queueMutexes;
+
 #ifndef NDEBUG
 private:
     VkDebugUtilsMessengerEXT debugMessenger;
@@ -525,6 +540,7 @@ private:
 
         // check queue family indeces
         std::optional<uint32_t> graphicsFamilyIndex;
+        uint32_t                graphicsQueueCount { 1 };
         std::optional<uint32_t> presentFamilyIndex;
         {
             uint32_t queueFamilyCount = 0;
@@ -538,6 +554,7 @@ private:
                 if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
                 {
                     graphicsFamilyIndex = i;
+                    graphicsQueueCount  = std::min(queueFamily.queueCount, 2u);
                 }
 
                 VkBool32 presentSupport = false;
@@ -557,7 +574,9 @@ private:
 
         return std::optional<PhysicalDevice> { std::in_place,
                                                physicalDeviceProperties.limits.maxSamplerAnisotropy,
+                                               physicalDeviceProperties.limits.timestampPeriod,
                                                graphicsFamilyIndex.value(),
+                                               graphicsQueueCount,
                                                presentFamilyIndex.value(),
                                                surfaceFormat.value(),
                                                presentMode.value(),
@@ -582,19 +601,20 @@ private:
     }
 
     VkDevice createLogicalDevice(const VkPhysicalDevice physicalDevice, const uint32_t graphicsFamilyIndex,
-                                 const uint32_t presentFamilyIndex)
+                                 const uint32_t graphicsQueueCount, const uint32_t presentFamilyIndex)
     {
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
         for (const auto queueFamily : std::set { graphicsFamilyIndex, presentFamilyIndex })
         {
-            constexpr float               queuePriority = 1.0f;
+            // streaming uploads yield to the render loop
+            constexpr std::array          queuePriorities { 1.0f, 0.5f };
             const VkDeviceQueueCreateInfo queueCreateInfo {
                 .sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
                 .pNext            = nullptr,
                 .flags            = {},
                 .queueFamilyIndex = queueFamily,
-                .queueCount       = 1,
-                .pQueuePriorities = &queuePriority,
+                .queueCount       = queueFamily == graphicsFamilyIndex ? graphicsQueueCount : 1,
+                .pQueuePriorities = queuePriorities.data(),
             };
             queueCreateInfos.push_back(queueCreateInfo);
         }
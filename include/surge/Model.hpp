@@ -19,6 +19,9 @@ struct ModelInfo
 };
 
 using SceneModelInfo = ModelInfo<VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT>;
+// vertices are additionally read as storage buffer by the compute skinning pass
+using SkinnedModelInfo = ModelInfo<VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT>;
 
 class Model
 {
@@ -37,6 +40,7 @@ public:
         , indexBuffer { loadedModel.indexBufferSize(),
                         IndexBufferInfo<Info::bufferUsageFlags, Info::memoryPropertyFlags> {} }
         , indexCount { static_cast<uint32_t>(loadedModel.indexSize()) }
+        , indexType { indexTypeOf<typename LoadedModel::Index>() }
     {
         if (transfer)
         {
@@ -55,6 +59,7 @@ public:
         , indexBuffer { loadedModel.indexBufferSize(),
                         IndexBufferInfo<Info::bufferUsageFlags, Info::memoryPropertyFlags> {} }
         , indexCount { static_cast<uint32_t>(loadedModel.indexSize()) }
+        , indexType { indexTypeOf<typename LoadedModel::Index>() }
     {
     }
 
@@ -95,6 +100,16 @@ public:
     uint32_t    vertexCount;
     Buffer      indexBuffer;
     uint32_t    indexCount;
+    VkIndexType indexType;
+
+private:
+    // of the indices as the loaded model holds them
+    template<typename Index>
+    static constexpr VkIndexType indexTypeOf()
+    {
+        static_assert(sizeof(Index) == sizeof(uint16_t) || sizeof(Index) == sizeof(uint32_t));
+        return sizeof(Index) == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    }
 };
 
 }  // namespace surge
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "surge/Context.hpp"
+#include "surge/Buffer.hpp"
+#include "surge/Descriptor.hpp"
+#include "surge/Pipeline.hpp"
+#include "surge/asset/Asset.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+namespace surge
+{
+
+// sums the weighted deltas of the active morph targets of every morphed node into one displacement per vertex of the
+// node's range of deformed vertices, which the skinning pass adds before skinning; targets of zero weight are not
+// dispatched
+class Morphing
+{
+public:
+    using DisplacementsBufferInfo = BufferInfo<VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT>;
+    using StorageDescr = Description<VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, Buffer>;
+
+    static constexpr uint32_t workGroupSize { 64 };
+    static constexpr float    epsilon { 1.e-5f };
+
+    // range of the deltas of one target, and where the mesh vertices they displace land for the node
+    struct PushBlock
+    {
+        uint32_t firstDelta;
+        uint32_t deltaCount;
+        float    weight;
+        uint32_t firstVertex;
+        uint32_t firstDisplacement;
+    };
+
+    Morphing(const std::filesystem::path& shaders, const asset::Asset& asset)
+        : asset { asset }
+        , displacements { asset.deformedVertexCount * 6 * sizeof(float), DisplacementsBufferInfo {} }
+        , descriptor { 1, StorageDescr { asset.morphTargets->deltas }, StorageDescr { displacements } }
+        , pipelineLayout { createPipelineLayout(createPushConstantRange<PushBlock>(VK_SHADER_STAGE_COMPUTE_BIT),
+                                                descriptor.setLayout) }
+        , pipeline { createComputePipeline(
+              VK_NULL_HANDLE, pipelineLayout,
+              Shader { ShaderInfo<VK_SHADER_STAGE_COMPUTE_BIT> { shaders / "morph.comp.spv", nullptr } }) }
+        , nodes { createNodes(asset) }
+    {
+        assert(asset.morphTargets);
+    }
+
+    ~Morphing()
+    {
+        context().destroy(pipeline);
+        context().destroy(pipelineLayout);
+    }
+
+    void dispatch(const VkCommandBuffer commandBuffer) const
+    {
+        // the previous frame may still be skinning from the displacements
+        barrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        vkCmdFillBuffer(commandBuffer, displacements.buffer, 0, VK_WHOLE_SIZE, 0);
+        barrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptor.set,
+                                0, nullptr);
+
+        // a vertex appears once per target, but the targets of a node add to the same vertices: the nth active targets
+        // of all nodes, whose ranges are disjoint, go in one round, and only rounds are separated by a barrier
+        dispatches.clear();
+        for (const auto* node : nodes)
+        {
+            const auto& targets = node->mesh->targets;
+            const auto& weights = node->state.weights;
+            std::size_t round { 0 };
+            for (std::size_t i = 0; i < targets.size() && i < weights.size(); ++i)
+            {
+                if (std::abs(weights[i]) >= epsilon && targets[i].deltaCount > 0)
+                {
+                    dispatches.push_back(Dispatch { node, i, round++ });
+                }
+            }
+        }
+        std::sort(dispatches.begin(), dispatches.end(),
+                  [](const Dispatch& a, const Dispatch& b) { return a.round < b.round; });
+
+        for (std::size_t j = 0; j < dispatches.size(); ++j)
+        {
+            const auto& [node, i, round] = dispatches[j];
+            if (j > 0 && round != dispatches[j - 1].round)
+            {
+                barrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+            }
+            const auto&     target = node->mesh->targets[i];
+            const PushBlock pushBlock { target.firstDelta, target.deltaCount, node->state.weights[i],
+                                        node->mesh->firstVertex(), node->deformedVertex };
+            vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushBlock),
+                               &pushBlock);
+            vkCmdDispatch(commandBuffer, (pushBlock.deltaCount + workGroupSize - 1) / workGroupSize, 1, 1);
+        }
+        state.activeTargets = static_cast<uint32_t>(dispatches.size());
+
+        barrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    const asset::Asset& asset;
+    Buffer              displacements;  // position and normal per deformed vertex
+    Descriptor          descriptor;
+    VkPipelineLayout    pipelineLayout;
+    VkPipeline          pipeline;
+    // nodes whose mesh has morph targets
+    std::vector<const asset::Node*> nodes;
+
+    struct State
+    {
+        uint32_t activeTargets { 0 };
+    };
+    mutable State state;
+
+private:
+    struct Dispatch
+    {
+        const asset::Node* node;
+        std::size_t        target;
+        std::size_t        round;  // active targets of the node before this one
+    };
+    // scratch of the recorded frame
+    mutable std::vector<Dispatch> dispatches;
+
+    static std::vector<const asset::Node*> createNodes(const asset::Asset& asset)
+    {
+        std::vector<const asset::Node*>               nodes;
+        const std::function<void(const asset::Node&)> collect = [&](const asset::Node& node)
+        {
+            if (node.mesh && !node.mesh->targets.empty())
+            {
+                nodes.push_back(&node);
+            }
+            for (const auto& child : node.children)
+            {
+                collect(child);
+            }
+        };
+        for (const auto& node : asset.mainScene().nodes)
+        {
+            collect(node);
+        }
+        return nodes;
+    }
+
+    void barrier(const VkCommandBuffer commandBuffer, const VkPipelineStageFlags srcStageMask,
+                 const VkAccessFlags srcAccessMask, const VkPipelineStageFlags dstStageMask,
+                 const VkAccessFlags dstAccessMask) const
+    {
+        const VkBufferMemoryBarrier bufferMemoryBarrier {
+            .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .pNext               = nullptr,
+            .srcAccessMask       = srcAccessMask,
+            .dstAccessMask       = dstAccessMask,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer              = displacements.buffer,
+            .offset              = 0,
+            .size                = VK_WHOLE_SIZE,
+        };
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 1, &bufferMemoryBarrier, 0,
+                             nullptr);
+    }
+};
+
+}  // namespace surge
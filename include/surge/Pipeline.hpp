@@ -90,6 +90,26 @@ constexpr VkPipelineRasterizationStateCreateInfo createRasterizationStateInfo(co
     };
 }
 
+constexpr VkPipelineDepthStencilStateCreateInfo createDepthStencilStateInfo(const VkCompareOp depthCompareOp);
+
+constexpr VkPipelineDepthStencilStateCreateInfo createDepthStencilStateInfo(const VkCompareOp depthCompareOp)
+{
+    return VkPipelineDepthStencilStateCreateInfo {
+        .sType                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .pNext                 = nullptr,
+        .flags                 = {},
+        .depthTestEnable       = VK_TRUE,
+        .depthWriteEnable      = VK_TRUE,
+        .depthCompareOp        = depthCompareOp,
+        .depthBoundsTestEnable = VK_FALSE,
+        .stencilTestEnable     = VK_FALSE,
+        .front                 = {},
+        .back                  = {},
+        .minDepthBounds        = 0.0f,
+        .maxDepthBounds        = 1.0f,
+    };
+}
+
 
 template<typename ShaderStages, typename... CreateInfos>
 VkPipeline createGraphicPipeline(const VkPipelineVertexInputStateCreateInfo vertexInputState,
@@ -263,4 +283,28 @@ VkPipeline createGraphicPipeline(const VkPipelineCache pipelineCache, const VkPi
     return createGraphicPipeline(geometry::createVertexInputState<Vertex>(), pipelineCache, pipelineLayout,
                                  shaderStages, createInfos...);
 }
+
+template<typename ShaderStages>
+VkPipeline createComputePipeline(const VkPipelineCache pipelineCache, const VkPipelineLayout pipelineLayout,
+                                 const ShaderStages& shaderStages)
+{
+    static_assert(std::tuple_size_v<decltype(shaderStages.shaders)> == 1);
+
+    const VkComputePipelineCreateInfo pipelineInfo {
+        .sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .pNext              = nullptr,
+        .flags              = {},
+        .stage              = shaderStages.shaders.front(),
+        .layout             = pipelineLayout,
+        .basePipelineHandle = VK_NULL_HANDLE,
+        .basePipelineIndex  = -1,
+    };
+
+    VkPipeline pipeline;
+    if (vkCreateComputePipelines(context().device, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create compute pipeline!");
+    }
+    return pipeline;
+}
 }  // namespace surge
@@ -6,6 +6,8 @@
 #include "surge/Swapchain.hpp"
 #include "surge/Image.hpp"
 
+#include <mutex>
+
 namespace surge
 {
 
@@ -75,6 +77,9 @@ public:
             throw std::runtime_error("failed to begin recording command buffer!");
         }
 
+        // passes feeding the rendering, e.g. compute skinning, are recorded before rendering begins
+        (prepare(commandBuffer, pipelines), ...);
+
         {
             const VkImageMemoryBarrier imageMemoryBarrierBegin {
                 .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
@@ -199,10 +204,6 @@ public:
                                                                    .pCommandBuffers    = &commandBuffer,
                                                                    .signalSemaphoreCount = 1,
                                                                    .pSignalSemaphores    = &rendered };
-        if (vkQueueSubmit(command.graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to submit to queue!");
-        }
 
         const VkPresentInfoKHR presentInfo {
             .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
@@ -214,8 +215,16 @@ public:
             .pImageIndices      = &imageIndex,
             .pResults           = nullptr,
         };
-        if (const auto result = vkQueuePresentKHR(command.presentQueue, &presentInfo);
-            result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized)
+        // the present queue is the graphics one when the families are the same
+        std::unique_lock lock { context().queueMutexes[command.queueIndex] };
+        if (vkQueueSubmit(command.graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to submit to queue!");
+        }
+        const auto result = vkQueuePresentKHR(command.presentQueue, &presentInfo);
+        lock.unlock();
+
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized)
         {
             recreateSwapchain();
         }
@@ -262,6 +271,15 @@ private:
     uint32_t                 imageIndex;
 
 private:
+    template<typename Pipeline>
+    static void prepare(const VkCommandBuffer commandBuffer, const Pipeline& pipeline)
+    {
+        if constexpr (requires { pipeline.prepare(commandBuffer); })
+        {
+            pipeline.prepare(commandBuffer);
+        }
+    }
+
     static Cycle<Semaphores> createSemaphores(const uint32_t count)
     {
         Cycle<Semaphores> semaphores { count };
@@ -296,7 +314,11 @@ private:
 
     void recreateSwapchain()
     {
-        vkDeviceWaitIdle(context().device);
+        {
+            // waiting for the device idle touches every queue, including the one of the uploads
+            const std::scoped_lock lock { context().queueMutexes[0], context().queueMutexes[1] };
+            vkDeviceWaitIdle(context().device);
+        }
         swapchain.emplace(DepthImageInfo {});
     }
 };
@@ -4,9 +4,13 @@
 #include "surge/Command.hpp"
 #include "surge/Camera.hpp"
 #include "surge/asset/Asset.hpp"
+#include "surge/asset/Crowd.hpp"
 #include "surge/Pipeline.hpp"
+#include "surge/Skinning.hpp"
+#include "surge/Timestamps.hpp"
 
 #include "surge/geometry/shapes.hpp"
+#include "surge/math/batch.hpp"
 
 namespace surge
 {
@@ -27,6 +31,25 @@ VkPolygonMode translate(const PolygonMode polygonMode)
     }
 }
 
+// each vertex stream of an asset where it starts in the model vertex buffer
+void bindVertexStreams(const VkCommandBuffer commandBuffer, const asset::Asset& asset);
+inline void bindVertexStreams(const VkCommandBuffer commandBuffer, const asset::Asset& asset)
+{
+    // the streams of one buffer, without allocating per draw
+    constexpr Size streamCount { 4 };
+    const auto     bindingCount = static_cast<uint32_t>(asset.layout.strides.size());
+    assert(bindingCount <= streamCount);
+
+    std::array<VkBuffer, streamCount> buffers;
+    buffers.fill(asset.model.vertexBuffer.buffer);
+    std::array<VkDeviceSize, streamCount> offsets {};
+    for (uint32_t binding = 0; binding < bindingCount; ++binding)
+    {
+        offsets[binding] = asset.layout.streamOffset(binding, asset.model.vertexCount);
+    }
+    vkCmdBindVertexBuffers(commandBuffer, 0, bindingCount, buffers.data(), offsets.data());
+}
+
 class Renderer
 {
 public:
@@ -60,49 +83,80 @@ public:
         math::Vector<4>    baseColorFactor;
         uint32_t           vertexStageFlag;
         uint32_t           fragmentStageFlag;
+        // first joint matrix of the node's palette
+        uint32_t jointOffset;
     };
     // static_assert(sizeof(PushBlock) < 128);
 
+    // node push block followed by the palette stride, so that the asset's fragment shader reads it unchanged
+    struct CrowdPushBlock
+    {
+        NodePushBlock node;
+        uint32_t      paletteStride;
+    };
+
 
     struct Renderable
     {
-        const asset::Asset& asset;
-        VkPipelineLayout    pipelineLayout;
-        VkPipeline          pipeline;
+        asset::Asset&           asset;
+        VkPipelineLayout        pipelineLayout;
+        VkPipeline              pipeline;
+        VkPipeline              skinnedPipeline;
+        VkPipeline              prePassPipeline;         // over the depth of the pre-pass, equal depths passing
+        VkPipeline              skinnedPrePassPipeline;  // skinned, over the depth of the pre-pass
+        VkPipeline              depthPipeline;           // positions only
+        VkPipeline              skinnedDepthPipeline;  // skinned positions only
+        std::optional<Skinning> skinning;
         // Pipelines           pipelines;
 
+        // morph targets are only applied by the compute pass, which morphed assets therefore always take
+        bool computeSkinning() const
+        {
+            return skinning && (asset.state.computeSkinning || asset.morphTargets);
+        }
+
         void drawNode(const VkCommandBuffer commandBuffer, const asset::Node& node,
-                      const math::Matrix<4, 4>& globalMatrix) const
+                      const math::Affine<>& globalMatrix) const
         {
             if (!node.state.active)
             {
                 return;
             }
 
+            // affine down the hierarchy, full only in the push block
+            const auto nodeMatrix = globalMatrix * node.localMatrix();
+
             // const NodePushBlock nodePushBlock { node.matrix() * globalMatrix, node.state.vertexStageFlag,
             //                                     node.state.fragmentStageFlag };
             NodePushBlock nodePushBlock {
-                .matrix            = globalMatrix * node.localMatrix(),
+                .matrix            = math::fullMatrix(nodeMatrix),
                 .baseColorFactor   = {},
                 .vertexStageFlag   = node.state.vertexStageFlag,
                 .fragmentStageFlag = node.state.fragmentStageFlag,
+                .jointOffset       = node.jointOffset,
             };
 
             if (node.mesh)
             {
+                if (computeSkinning())
+                {
+                    // the skinned vertices are bound past the asset streams, at the node's own range
+                    const auto offset = Skinning::outputOffset(node);
+                    vkCmdBindVertexBuffers(commandBuffer, static_cast<uint32_t>(asset.layout.strides.size()), 1,
+                                           &skinning->output.buffer, &offset);
+                }
                 for (const auto& primitive : node.mesh->primitives)
                 {
-                    constexpr VkDeviceSize offset { 0 };
-                    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &asset.model.vertexBuffer.buffer, &offset);
-                    vkCmdBindIndexBuffer(commandBuffer, asset.model.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
-
                     auto setPolygonMode = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
                         vkGetInstanceProcAddr(context().instance, "vkCmdSetPolygonModeEXT"));
                     assert(setPolygonMode);
                     setPolygonMode(commandBuffer, translate(node.state.polygonMode));
                     // setPolygonMode(commandBuffer, translate(PolygonMode::line));
 
-                    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                      depthPrePass() ? (computeSkinning() ? skinnedPrePassPipeline : prePassPipeline) :
+                                      computeSkinning() ? skinnedPipeline :
+                                                          pipeline);
 
                     // bind material
                     constexpr uint32_t materialIndex = 1;
@@ -115,7 +169,8 @@ public:
                                        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
                                        sizeof(NodePushBlock), &nodePushBlock);
 
-                    vkCmdDrawIndexed(commandBuffer, primitive.indexCount, 1, primitive.firstIndex, 0, 0);
+                    vkCmdDrawIndexed(commandBuffer, primitive.indexCount, 1, primitive.firstIndex,
+                                     primitive.vertexOffset, 0);
 
                     // if (primitive.state.boundingBox)
                     // {
@@ -148,12 +203,91 @@ public:
             }
             for (const auto& child : node.children)
             {
-                drawNode(commandBuffer, child, nodePushBlock.matrix);
+                drawNode(commandBuffer, child, nodeMatrix);
+            }
+        }
+
+        // whether the depth pass sees the positions the main pass draws; vertex shader skinning has no depth pass
+        bool depthPrePass() const
+        {
+            return asset.state.active && asset.state.depthPrePass && (!skinning || computeSkinning());
+        }
+
+        void drawDepthNode(const VkCommandBuffer commandBuffer, const asset::Node& node,
+                           const math::Affine<>& globalMatrix) const
+        {
+            if (!node.state.active)
+            {
+                return;
+            }
+
+            const auto nodeMatrix = globalMatrix * node.localMatrix();
+            // wire nodes are left to the main pass
+            if (node.mesh && node.state.polygonMode == PolygonMode::fill)
+            {
+                const NodePushBlock nodePushBlock {
+                    .matrix            = math::fullMatrix(nodeMatrix),
+                    .baseColorFactor   = {},
+                    .vertexStageFlag   = node.state.vertexStageFlag,
+                    .fragmentStageFlag = 0,
+                    .jointOffset       = node.jointOffset,
+                };
+                if (computeSkinning())
+                {
+                    const auto offset = Skinning::outputOffset(node);
+                    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &skinning->output.buffer, &offset);
+                }
+                vkCmdPushConstants(commandBuffer, pipelineLayout,
+                                   VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                                   sizeof(NodePushBlock), &nodePushBlock);
+                for (const auto& primitive : node.mesh->primitives)
+                {
+                    vkCmdDrawIndexed(commandBuffer, primitive.indexCount, 1, primitive.firstIndex,
+                                     primitive.vertexOffset, 0);
+                }
+            }
+            for (const auto& child : node.children)
+            {
+                drawDepthNode(commandBuffer, child, nodeMatrix);
+            }
+        }
+
+        // the positions alone, so that the main pass shades each pixel once
+        void drawDepth(const VkCommandBuffer commandBuffer, const VkDescriptorSet sceneDescriptor,
+                       const math::Affine<>& globalMatrix) const
+        {
+            if (!depthPrePass())
+            {
+                return;
+            }
+
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              computeSkinning() ? skinnedDepthPipeline : depthPipeline);
+
+            auto setPolygonMode = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
+                vkGetInstanceProcAddr(context().instance, "vkCmdSetPolygonModeEXT"));
+            assert(setPolygonMode);
+            setPolygonMode(commandBuffer, VK_POLYGON_MODE_FILL);
+
+            constexpr uint32_t sceneUniformIndex = 0;
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, sceneUniformIndex,
+                                    1, &sceneDescriptor, 0, nullptr);
+
+            // the skinned positions are bound per node
+            if (!computeSkinning())
+            {
+                bindVertexStreams(commandBuffer, asset);
+            }
+            vkCmdBindIndexBuffer(commandBuffer, asset.model.indexBuffer.buffer, 0, asset.model.indexType);
+
+            for (const auto& node : asset.mainScene().nodes)
+            {
+                drawDepthNode(commandBuffer, node, globalMatrix);
             }
         }
 
         void draw(const VkCommandBuffer commandBuffer, const VkDescriptorSet sceneDescriptor,
-                  const math::Matrix<4, 4>& globalMatrix) const
+                  const math::Affine<>& globalMatrix) const
         {
             if (!asset.state.active)
             {
@@ -172,6 +306,10 @@ public:
                 vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
                                         jointMatricesIndex, 1, &asset.jointMatricesSSBO->descriptorSet, 0, nullptr);
             }
+
+            bindVertexStreams(commandBuffer, asset);
+            vkCmdBindIndexBuffer(commandBuffer, asset.model.indexBuffer.buffer, 0, asset.model.indexType);
+
             for (const auto& node : asset.mainScene().nodes)
             {
                 drawNode(commandBuffer, node, globalMatrix);
@@ -179,27 +317,142 @@ public:
         }
 
         ~Renderable()
+        {
+            context().destroy(skinnedDepthPipeline);
+            context().destroy(depthPipeline);
+            context().destroy(skinnedPrePassPipeline);
+            context().destroy(prePassPipeline);
+            context().destroy(skinnedPipeline);
+            context().destroy(pipeline);
+            context().destroy(pipelineLayout);
+        }
+    };
+
+    // one instanced draw per skinned primitive for all instances of a crowd
+    struct CrowdRenderable
+    {
+        const asset::Crowd& crowd;
+        VkPipelineLayout    pipelineLayout;
+        VkPipeline          pipeline;
+
+        void drawNode(const VkCommandBuffer commandBuffer, const asset::Node& node) const
+        {
+            if (!node.state.active)
+            {
+                return;
+            }
+
+            if (node.mesh && node.skinIndex)
+            {
+                // the node matrix is part of the joint matrices of the crowd palettes
+                CrowdPushBlock crowdPushBlock {
+                    .node = NodePushBlock {
+                        .matrix            = math::fullMatrix(math::identity<4>),
+                        .baseColorFactor   = {},
+                        .vertexStageFlag   = node.state.vertexStageFlag,
+                        .fragmentStageFlag = 0,
+                        .jointOffset       = node.jointOffset,
+                    },
+                    .paletteStride = crowd.paletteStride,
+                };
+                for (const auto& primitive : node.mesh->primitives)
+                {
+                    constexpr uint32_t materialIndex = 1;
+                    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
+                                            materialIndex, 1, &primitive.material.descriptorSet, 0, nullptr);
+
+                    crowdPushBlock.node.baseColorFactor = primitive.material.baseColorFactor;
+                    vkCmdPushConstants(commandBuffer, pipelineLayout,
+                                       VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                                       sizeof(CrowdPushBlock), &crowdPushBlock);
+
+                    vkCmdDrawIndexed(commandBuffer, primitive.indexCount, crowd.instanceCount(), primitive.firstIndex,
+                                     primitive.vertexOffset, 0);
+                }
+            }
+            for (const auto& child : node.children)
+            {
+                drawNode(commandBuffer, child);
+            }
+        }
+
+        void draw(const VkCommandBuffer commandBuffer, const VkDescriptorSet sceneDescriptor) const
+        {
+            if (!crowd.state.active)
+            {
+                return;
+            }
+
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+            auto setPolygonMode = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
+                vkGetInstanceProcAddr(context().instance, "vkCmdSetPolygonModeEXT"));
+            assert(setPolygonMode);
+            setPolygonMode(commandBuffer, VK_POLYGON_MODE_FILL);
+
+            constexpr uint32_t sceneUniformIndex = 0;
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, sceneUniformIndex,
+                                    1, &sceneDescriptor, 0, nullptr);
+            constexpr uint32_t crowdIndex = 2;
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, crowdIndex, 1,
+                                    &crowd.descriptor.set, 0, nullptr);
+
+            bindVertexStreams(commandBuffer, crowd.asset);
+            vkCmdBindIndexBuffer(commandBuffer, crowd.asset.model.indexBuffer.buffer, 0, crowd.asset.model.indexType);
+
+            for (const auto& node : crowd.asset.mainScene().nodes)
+            {
+                drawNode(commandBuffer, node);
+            }
+        }
+
+        ~CrowdRenderable()
         {
             context().destroy(pipeline);
             context().destroy(pipelineLayout);
         }
     };
 
-    Renderer(const std::filesystem::path& shaders, std::vector<asset::Asset>& assets)
-        : assets { assets }
+    Renderer(const std::filesystem::path& shaders, std::vector<asset::Asset>& assets,
+             std::vector<asset::Crowd>& crowds)
+        : shaders { shaders }
+        , assets { assets }
+        , crowds { crowds }
         , camera { 16.0 / 9.0, { 0.0f, 1.0f, 3.0f }, { 0.0f, 0.0f, -1.0f } }
         , scene { 2 * sizeof(math::Matrix<4, 4>), UniformBufferInfo {} }
         , descriptor { 1, UniformBufferDescription<VK_SHADER_STAGE_VERTEX_BIT> { scene } }
         , renderables { createRenderables(shaders, descriptor, assets) }
+        , crowdRenderables { createCrowdRenderables(shaders, descriptor, crowds) }
+        , timestamps { 2 * static_cast<uint32_t>(renderables.size()), context().frameBufferCount() }
     {
         assets.front().mainScene().nodes.front().state.polygonMode = PolygonMode::line;
     }
 
-    std::vector<asset::Asset>&  assets;
-    mutable Camera<true, false> camera;
-    Buffer                      scene;
-    Descriptor                  descriptor;
-    std::vector<Renderable>     renderables;
+    const std::filesystem::path              shaders;
+    std::vector<asset::Asset>&               assets;
+    std::vector<asset::Crowd>&               crowds;
+    mutable Camera<true, false>              camera;
+    Buffer                                   scene;
+    Descriptor                               descriptor;
+    std::vector<std::unique_ptr<Renderable>> renderables;
+    std::vector<CrowdRenderable>             crowdRenderables;
+    // skinning and draw pass per renderable present at construction; published ones go untimed
+    mutable Timestamps timestamps;
+    // of the renderables, refilled every update
+    math::batch::Spheres bounds;
+    std::vector<uint8_t> visible;
+
+    // pipelines of an asset; creating them touches no state of the renderer, so it may run on a loading thread
+    std::unique_ptr<Renderable> createRenderable(asset::Asset& asset) const
+    {
+        return createRenderable(shaders, descriptor, asset);
+    }
+
+    // starts drawing an asset that is resident on the device; between frames
+    void publish(std::unique_ptr<Renderable> renderable)
+    {
+        renderables.push_back(std::move(renderable));
+    }
 
 
     void update(const VkExtent2D, const UserInteraction& ui)
@@ -211,10 +464,32 @@ public:
         };
         memcpy(scene.mapped, sceneMatrices.data(), 2 * sizeof(math::Matrix<4, 4>));
 
-        for (auto& asset : assets)
+        // the bounding spheres of all assets against the view frustum at once, then an animation interval each
+        bounds.resize(0);
+        for (const auto& renderable : renderables)
         {
+            const auto [center, radius] = asset::AnimationLod::sphere(renderable->asset.bounds,
+                                                                      renderable->asset.state.translation);
+            bounds.push_back(center, radius);
+        }
+        const auto viewProjection =
+            math::fullMatrix(camera.mats.perspective) * math::fullMatrix(camera.mats.view);
+        math::batch::intersect(math::batch::frustum(viewProjection), bounds, visible);
+        for (Size i = 0; i < renderables.size(); ++i)
+        {
+            auto& asset = renderables[i]->asset;
+            asset.schedule(asset::AnimationLod::schedule(asset.state.lod, visible[i] != 0, bounds.center[i],
+                                                         bounds.radius[i], camera.vecs.position, camera.vecs.front,
+                                                         camera.fovy));
             asset.update(ui.elapsedTime);
         }
+        for (auto& crowd : crowds)
+        {
+            if (crowd.state.active)
+            {
+                crowd.update(ui.elapsedTime);
+            }
+        }
     }
 
     // void draw(const VkCommandBuffer commandBuffer, const Model& model, const asset::Node& node,
@@ -284,6 +559,35 @@ public:
     //     }
     // }
 
+    // records the passes that have to finish before rendering starts
+    void prepare(const VkCommandBuffer commandBuffer) const
+    {
+        timestamps.begin(commandBuffer);
+        for (uint32_t i = 0; i < renderables.size() && timed(i); ++i)
+        {
+            renderables[i]->asset.state.gpuTime = { timestamps.milliseconds.at(2 * i),
+                                                    timestamps.milliseconds.at(2 * i + 1) };
+        }
+
+        for (uint32_t i = 0; i < renderables.size(); ++i)
+        {
+            const auto& renderable = *renderables[i];
+            // nodes held by animation level of detail leave the skinned vertices as they are
+            if (renderable.asset.state.active && renderable.computeSkinning() && renderable.asset.state.posed)
+            {
+                if (timed(i))
+                {
+                    timestamps.start(commandBuffer, 2 * i);
+                }
+                renderable.skinning->dispatch(commandBuffer);
+                if (timed(i))
+                {
+                    timestamps.stop(commandBuffer, 2 * i);
+                }
+            }
+        }
+    }
+
     void draw(const VkCommandBuffer commandBuffer, const VkExtent2D extent) const
     {
         const VkViewport viewport {
@@ -302,43 +606,153 @@ public:
         };
         vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
+        // every depth pass first, so that the main passes of all assets test against the whole scene
         for (const auto& renderable : renderables)
+        {
+            renderable->drawDepth(commandBuffer, descriptor.set,
+                                  math::affine(math::Translation { renderable->asset.state.translation }));
+        }
+
+        for (uint32_t i = 0; i < renderables.size(); ++i)
         {
             // constexpr math::Scaling<> scaling { 0.1f, 0.1f, 0.1f };
-            renderable.draw(commandBuffer, descriptor.set, math::fullMatrix(math::identity<4>));
+            if (timed(i))
+            {
+                timestamps.start(commandBuffer, 2 * i + 1);
+            }
+            renderables[i]->draw(commandBuffer, descriptor.set,
+                                 math::affine(math::Translation { renderables[i]->asset.state.translation }));
+            if (timed(i))
+            {
+                timestamps.stop(commandBuffer, 2 * i + 1);
+            }
+        }
+        for (const auto& crowdRenderable : crowdRenderables)
+        {
+            crowdRenderable.draw(commandBuffer, descriptor.set);
         }
     }
 
 
 private:
-    static std::vector<Renderable> createRenderables(const std::filesystem::path& shaders, const Descriptor& descriptor,
-                                                     const std::vector<asset::Asset>& assets)
+    bool timed(const uint32_t renderable) const
     {
-        std::vector<Renderable> renderables;
+        return 2 * renderable + 1 < timestamps.passCount;
+    }
+
+    static std::vector<std::unique_ptr<Renderable>> createRenderables(const std::filesystem::path& shaders,
+                                                                      const Descriptor&            descriptor,
+                                                                      std::vector<asset::Asset>&   assets)
+    {
+        std::vector<std::unique_ptr<Renderable>> renderables;
         renderables.reserve(assets.size());
-        for (const auto& asset : assets)
+        for (auto& asset : assets)
         {
-            constexpr VkPushConstantRange pushConstantRange { createPushConstantRange<NodePushBlock>(
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT) };
+            renderables.push_back(createRenderable(shaders, descriptor, asset));
+        }
+        return renderables;
+    }
+
+    static std::unique_ptr<Renderable> createRenderable(const std::filesystem::path& shaders,
+                                                        const Descriptor& descriptor, asset::Asset& asset)
+    {
+        constexpr VkPushConstantRange pushConstantRange { createPushConstantRange<NodePushBlock>(
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT) };
+
+        const VkPipelineLayout pipelineLayout {
+            asset.jointMatricesSSBO ?
+                createPipelineLayout(pushConstantRange, descriptor.setLayout, asset.materialDescriptorSetLayout,
+                                     asset.jointMatricesSSBO->descriptorSetLayout) :
+                createPipelineLayout(pushConstantRange, descriptor.setLayout, asset.materialDescriptorSetLayout)
+        };
 
-            const VkPipelineLayout pipelineLayout {
-                asset.jointMatricesSSBO ?
-                    createPipelineLayout(pushConstantRange, descriptor.setLayout, asset.materialDescriptorSetLayout,
-                                         asset.jointMatricesSSBO->descriptorSetLayout) :
-                    createPipelineLayout(pushConstantRange, descriptor.setLayout, asset.materialDescriptorSetLayout)
+        const auto   verticesShader  = shaders / (asset.shader + ".vert.spv");
+        const auto   fragmentsShader = shaders / (asset.shader + ".frag.spv");
+        // static shaders have no skinning method to specialize
+        const auto   skinningMethod  = static_cast<uint32_t>(asset.skinningMethod);
+        const Shader shader {
+            ShaderInfo<VK_SHADER_STAGE_VERTEX_BIT, uint32_t> { verticesShader, skinningMethod },
+            ShaderInfo<VK_SHADER_STAGE_FRAGMENT_BIT> { fragmentsShader, nullptr },
+        };
+        // no colour is written by the depth pass, which has no fragment shader
+        const Shader depthShader {
+            ShaderInfo<VK_SHADER_STAGE_VERTEX_BIT> { shaders / "depth.vert.spv", nullptr },
+        };
+        constexpr VkPipelineColorBlendAttachmentState depthColorBlendAttachmentState {
+            .blendEnable         = VK_FALSE,
+            .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
+            .dstColorBlendFactor = VK_BLEND_FACTOR_ZERO,
+            .colorBlendOp        = VK_BLEND_OP_ADD,
+            .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+            .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+            .alphaBlendOp        = VK_BLEND_OP_ADD,
+            .colorWriteMask      = 0,
+        };
+
+        // the main pass keeps the default depth test unless it draws again over the depth of the pre-pass, which is
+        // toggled per asset
+        constexpr auto prePassDepthStencilState = createDepthStencilStateInfo(VK_COMPARE_OP_LESS_OR_EQUAL);
+        const auto     vertexInputState         = asset.layout.vertexInputState();
+        const auto     depthVertexInputState    = asset.layout.vertexInputState({ geometry::Attribute::position });
+        auto           renderable               = std::make_unique<Renderable>(
+            asset, pipelineLayout,
+            createGraphicPipeline(vertexInputState.createInfo(), VK_NULL_HANDLE, pipelineLayout, shader),
+            VK_NULL_HANDLE,
+            createGraphicPipeline(vertexInputState.createInfo(), VK_NULL_HANDLE, pipelineLayout, shader,
+                                  prePassDepthStencilState),
+            VK_NULL_HANDLE,
+            createGraphicPipeline(depthVertexInputState.createInfo(), VK_NULL_HANDLE, pipelineLayout, depthShader,
+                                  depthColorBlendAttachmentState),
+            VK_NULL_HANDLE);
+
+        if (asset.jointMatricesSSBO || asset.morphTargets)
+        {
+            const Shader skinnedShader {
+                ShaderInfo<VK_SHADER_STAGE_VERTEX_BIT> { shaders / "gltf_skinned.vert.spv", nullptr },
+                ShaderInfo<VK_SHADER_STAGE_FRAGMENT_BIT> { fragmentsShader, nullptr },
             };
+            const auto skinnedVertexInputState = createSkinnedVertexInputState(asset.layout);
+            renderable->skinnedPipeline = createGraphicPipeline(skinnedVertexInputState.createInfo(), VK_NULL_HANDLE,
+                                                                pipelineLayout, skinnedShader);
+            renderable->skinnedPrePassPipeline =
+                createGraphicPipeline(skinnedVertexInputState.createInfo(), VK_NULL_HANDLE, pipelineLayout,
+                                      skinnedShader, prePassDepthStencilState);
+            const auto skinnedDepthVertexInputState = createSkinnedDepthVertexInputState();
+            renderable->skinnedDepthPipeline =
+                createGraphicPipeline(skinnedDepthVertexInputState.createInfo(), VK_NULL_HANDLE, pipelineLayout,
+                                      depthShader, depthColorBlendAttachmentState);
+            renderable->skinning.emplace(shaders, asset);
+        }
+        return renderable;
+    }
+
+    static std::vector<CrowdRenderable> createCrowdRenderables(const std::filesystem::path&     shaders,
+                                                               const Descriptor&                descriptor,
+                                                               const std::vector<asset::Crowd>& crowds)
+    {
+        std::vector<CrowdRenderable> crowdRenderables;
+        crowdRenderables.reserve(crowds.size());
+        for (const auto& crowd : crowds)
+        {
+            constexpr VkPushConstantRange pushConstantRange { createPushConstantRange<CrowdPushBlock>(
+                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT) };
+
+            const auto&            asset = crowd.asset;
+            const VkPipelineLayout pipelineLayout { createPipelineLayout(
+                pushConstantRange, descriptor.setLayout, asset.materialDescriptorSetLayout,
+                crowd.descriptor.setLayout) };
 
-            const auto   verticesShader  = shaders / (asset.shader + ".vert.spv");
-            const auto   fragmentsShader = shaders / (asset.shader + ".frag.spv");
             const Shader shader {
-                ShaderInfo<VK_SHADER_STAGE_VERTEX_BIT> { verticesShader, nullptr },
-                ShaderInfo<VK_SHADER_STAGE_FRAGMENT_BIT> { fragmentsShader, nullptr },
+                ShaderInfo<VK_SHADER_STAGE_VERTEX_BIT, uint32_t> { shaders / "gltf_crowd.vert.spv",
+                                                                   static_cast<uint32_t>(asset.skinningMethod) },
+                ShaderInfo<VK_SHADER_STAGE_FRAGMENT_BIT> { shaders / (asset.shader + ".frag.spv"), nullptr },
             };
-            renderables.emplace_back(
-                asset, pipelineLayout,
-                createGraphicPipeline(asset.vertexInputState, VK_NULL_HANDLE, pipelineLayout, shader));
+            const auto vertexInputState = asset.layout.vertexInputState();
+            crowdRenderables.emplace_back(
+                crowd, pipelineLayout,
+                createGraphicPipeline(vertexInputState.createInfo(), VK_NULL_HANDLE, pipelineLayout, shader));
         }
-        return renderables;
+        return crowdRenderables;
     }
 };
 
@@ -54,7 +54,7 @@ private:
         return VkSpecializationInfo {
             .mapEntryCount = 1,
             .pMapEntries   = &entry,
-            .dataSize      = sizeof(SpecializationEntry),
+            .dataSize      = sizeof(Value),
             .pData         = &value,
         };
     }
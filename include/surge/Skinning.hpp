@@ -0,0 +1,250 @@
+#pragma once
+
+#include "surge/Context.hpp"
+#include "surge/Buffer.hpp"
+#include "surge/Descriptor.hpp"
+#include "surge/Morphing.hpp"
+#include "surge/Pipeline.hpp"
+#include "surge/asset/Asset.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace surge
+{
+
+// skinned attributes written by the compute skinning pass, consumed from the vertex binding past the asset streams
+struct SkinnedVertex
+{
+    math::Vector<3> position;
+    math::Vector<3> normal;
+};
+
+// the asset streams keep everything but position and normal, which come from the skinned vertices as floats whatever
+// their format in the asset
+inline geometry::VertexInputState createSkinnedVertexInputState(const geometry::VertexLayout& layout)
+{
+    const auto skinnedBinding = static_cast<uint32_t>(layout.strides.size());
+    auto       state          = layout.vertexInputState();
+    state.bindings.push_back(VkVertexInputBindingDescription {
+        .binding   = skinnedBinding,
+        .stride    = sizeof(SkinnedVertex),
+        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+    });
+    for (Size i = 0; i < layout.slots.size(); ++i)
+    {
+        const auto attribute = layout.slots[i].attribute;
+        if (attribute == geometry::Attribute::position || attribute == geometry::Attribute::normal)
+        {
+            auto& description   = state.attributes[i];
+            description.binding = skinnedBinding;
+            description.format  = VK_FORMAT_R32G32B32_SFLOAT;
+            description.offset  = attribute == geometry::Attribute::position ? offsetof(SkinnedVertex, position) :
+                                                                               offsetof(SkinnedVertex, normal);
+        }
+    }
+    return state;
+}
+
+// the skinned positions alone, for the depth pass
+inline geometry::VertexInputState createSkinnedDepthVertexInputState()
+{
+    return {
+        .bindings   = { VkVertexInputBindingDescription {
+              .binding   = 0,
+              .stride    = sizeof(SkinnedVertex),
+              .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+        } },
+        .attributes = { VkVertexInputAttributeDescription {
+            .location = 0,
+            .binding  = 0,
+            .format   = VK_FORMAT_R32G32B32_SFLOAT,
+            .offset   = offsetof(SkinnedVertex, position),
+        } },
+    };
+}
+
+// blends the morph targets and joint matrices into every vertex of an asset once per frame, so that all passes
+// drawing the asset afterwards read the deformed vertices as static geometry
+class Skinning
+{
+public:
+    using OutputBufferInfo = BufferInfo<VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT>;
+    using StorageDescr     = Description<VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, Buffer>;
+
+    static constexpr uint32_t workGroupSize { 64 };
+    static constexpr uint32_t skinnedFlag { 1 };
+    static constexpr uint32_t morphedFlag { 2 };
+    static constexpr uint32_t wideJointsFlag { 4 };  // joint indices as uint16 rather than uint8
+
+    // an attribute of the first vertex in the asset vertex buffer and the stride of its stream, in 32 bit words
+    struct Words
+    {
+        uint32_t offset;
+        uint32_t stride;
+    };
+
+    // vertex range of one node and its palette, layout of the asset vertices, then where the node's range of the
+    // output starts
+    struct PushBlock
+    {
+        uint32_t flags;
+        uint32_t firstVertex;
+        uint32_t vertexCount;
+        uint32_t jointOffset;
+        Words    position;
+        Words    normal;
+        Words    jointIndex;
+        Words    jointWeight;
+        uint32_t firstOutput;
+    };
+
+    Skinning(const std::filesystem::path& shaders, const asset::Asset& asset)
+        : asset { asset }
+        , output { asset.deformedVertexCount * sizeof(SkinnedVertex), OutputBufferInfo {} }
+        , morphing { asset.morphTargets ? std::optional<Morphing> { std::in_place, shaders, asset } :
+                                          std::optional<Morphing> {} }
+        // the vertices stand in for the buffers of deformations the asset does not have
+        , descriptor { 1, StorageDescr { asset.model.vertexBuffer },
+                       StorageDescr { asset.jointMatricesSSBO ? asset.jointMatricesSSBO->buffer :
+                                                                asset.model.vertexBuffer },
+                       StorageDescr { output },
+                       StorageDescr { morphing ? morphing->displacements : asset.model.vertexBuffer } }
+        , pipelineLayout { createPipelineLayout(createPushConstantRange<PushBlock>(VK_SHADER_STAGE_COMPUTE_BIT),
+                                                descriptor.setLayout) }
+        , pipeline { createComputePipeline(
+              VK_NULL_HANDLE, pipelineLayout,
+              Shader { ShaderInfo<VK_SHADER_STAGE_COMPUTE_BIT, uint32_t> {
+                  shaders / "skinning.comp.spv", static_cast<uint32_t>(asset.skinningMethod) } }) }
+        , dispatches { createDispatches(asset) }
+    {
+        assert(asset.jointMatricesSSBO || asset.morphTargets);
+    }
+
+    ~Skinning()
+    {
+        context().destroy(pipeline);
+        context().destroy(pipelineLayout);
+    }
+
+    void dispatch(const VkCommandBuffer commandBuffer) const
+    {
+        if (morphing)
+        {
+            morphing->dispatch(commandBuffer);
+        }
+
+        // the previous frame may still be drawing from the skinned vertices
+        barrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptor.set,
+                                0, nullptr);
+
+        for (const auto& pushBlock : dispatches)
+        {
+            vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushBlock),
+                               &pushBlock);
+            vkCmdDispatch(commandBuffer, (pushBlock.vertexCount + workGroupSize - 1) / workGroupSize, 1, 1);
+        }
+
+        barrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+    }
+
+    const asset::Asset&     asset;
+    Buffer                  output;
+    std::optional<Morphing> morphing;
+    Descriptor              descriptor;
+    VkPipelineLayout        pipelineLayout;
+    VkPipeline              pipeline;
+    // one per node with a mesh, as every vertex drawn from the output has to be written
+    std::vector<PushBlock> dispatches;
+
+    // where the output of a node is bound so that the vertex offsets of its primitives land in its own range
+    static VkDeviceSize outputOffset(const asset::Node& node)
+    {
+        assert(node.mesh && node.deformedVertex >= node.mesh->firstVertex());
+        return VkDeviceSize { node.deformedVertex - node.mesh->firstVertex() } * sizeof(SkinnedVertex);
+    }
+
+private:
+    // each node writes its own range of the output, so that nodes sharing a mesh keep their own palette
+    static std::vector<PushBlock> createDispatches(const asset::Asset& asset)
+    {
+        // every slot and stream of the glTF vertex is a whole number of words; the joints are absent without skins and
+        // then unread
+        const auto& layout = asset.layout;
+        const auto  words  = [&](const geometry::Attribute attribute)
+        {
+            if (!layout.has(attribute))
+            {
+                return Words { 0, 0 };
+            }
+            const auto& slot   = layout.slot(attribute);
+            const auto  offset = layout.streamOffset(slot.binding, asset.model.vertexCount) + slot.offset;
+            assert(offset % sizeof(uint32_t) == 0 && layout.strides[slot.binding] % sizeof(uint32_t) == 0);
+            return Words { static_cast<uint32_t>(offset / sizeof(uint32_t)),
+                           static_cast<uint32_t>(layout.strides[slot.binding] / sizeof(uint32_t)) };
+        };
+
+        const auto wideJoints = layout.has(geometry::Attribute::jointIndex) &&
+                                layout.slot(geometry::Attribute::jointIndex).format == VK_FORMAT_R16G16B16A16_UINT;
+
+        std::vector<PushBlock>                        dispatches;
+        const std::function<void(const asset::Node&)> collect = [&](const asset::Node& node)
+        {
+            if (node.mesh)
+            {
+                dispatches.push_back(PushBlock {
+                    .flags       = (node.skinIndex && asset.jointMatricesSSBO ? skinnedFlag : 0) |
+                                   (!node.mesh->targets.empty() && asset.morphTargets ? morphedFlag : 0) |
+                                   (wideJoints ? wideJointsFlag : 0),
+                    .firstVertex = node.mesh->firstVertex(),
+                    .vertexCount = node.mesh->vertexCount(),
+                    .jointOffset = node.jointOffset,
+                    .position    = words(geometry::Attribute::position),
+                    .normal      = words(geometry::Attribute::normal),
+                    .jointIndex  = words(geometry::Attribute::jointIndex),
+                    .jointWeight = words(geometry::Attribute::jointWeight),
+                    .firstOutput = node.deformedVertex,
+                });
+            }
+            for (const auto& child : node.children)
+            {
+                collect(child);
+            }
+        };
+        for (const auto& node : asset.mainScene().nodes)
+        {
+            collect(node);
+        }
+        return dispatches;
+    }
+
+    void barrier(const VkCommandBuffer commandBuffer, const VkPipelineStageFlags srcStageMask,
+                 const VkAccessFlags srcAccessMask, const VkPipelineStageFlags dstStageMask,
+                 const VkAccessFlags dstAccessMask) const
+    {
+        const VkBufferMemoryBarrier bufferMemoryBarrier {
+            .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .pNext               = nullptr,
+            .srcAccessMask       = srcAccessMask,
+            .dstAccessMask       = dstAccessMask,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer              = output.buffer,
+            .offset              = 0,
+            .size                = VK_WHOLE_SIZE,
+        };
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 1, &bufferMemoryBarrier, 0,
+                             nullptr);
+    }
+};
+
+}  // namespace surge
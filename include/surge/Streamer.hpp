@@ -0,0 +1,248 @@
+#pragma once
+
+#include "surge/Command.hpp"
+#include "surge/Context.hpp"
+#include "surge/Defaults.hpp"
+#include "surge/Model.hpp"
+#include "surge/Renderer.hpp"
+#include "surge/UserInteraction.hpp"
+#include "surge/asset/Asset.hpp"
+#include "surge/geometry/shapes.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace surge
+{
+
+// imports assets on a loading thread while frames go on: the asset is built, its buffers and textures are uploaded
+// through a queue of their own when the device offers a second one, and its pipelines are created, all before the
+// render thread hands it to the renderer. Until then a wire box stands in for it; a failed load is reported and its
+// box dropped. Publishing is held to a time budget per frame, so that a burst of completed loads spreads over several
+// frames
+class Streamer
+{
+public:
+    struct Request
+    {
+        std::string           name;
+        std::filesystem::path path;
+        math::Vector<3>       translation { 0, 0, 0 };
+        math::Vector<3>       extent { 1, 1, 1 };  // of the placeholder, centered on the translation
+    };
+
+    Streamer(const Defaults& defaults, Renderer& renderer, const double budget = 1e-3)
+        : defaults { defaults }
+        , renderer { renderer }
+        , budget { budget }
+        , command { streamingQueueIndex() }
+        , box { command, geometry::cubeLine, true, SceneModelInfo {} }
+        , worker { [this](const std::stop_token stop) { work(stop); } }
+    {
+    }
+
+    Streamer(const Streamer&)            = delete;
+    Streamer& operator=(const Streamer&) = delete;
+
+    // queues an asset for loading; on the render thread
+    void request(Request request)
+    {
+        const auto id = nextId++;
+        pending.emplace_back(id, request);
+        {
+            const std::lock_guard lock { mutex };
+            requests.emplace_back(id, std::move(request));
+        }
+        requested.notify_one();
+    }
+
+    // publishes the loaded assets until the budget of the frame is spent; a failed load is reported and drops its box
+    void update(const VkExtent2D, const UserInteraction&)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < budget)
+        {
+            Loaded next;
+            {
+                const std::lock_guard lock { mutex };
+                if (loaded.empty())
+                {
+                    break;
+                }
+                next = std::move(loaded.front());
+                loaded.pop_front();
+            }
+            if (next.error)
+            {
+                report(next.id, next.error);
+            }
+            else
+            {
+                renderer.publish(std::move(next.renderable));
+                assets.push_back(std::move(next.asset));
+            }
+            std::erase_if(pending, [&](const auto& job) { return job.first == next.id; });
+        }
+    }
+
+    // a wire box per asset still loading
+    void draw(const VkCommandBuffer commandBuffer, const VkExtent2D) const
+    {
+        if (pending.empty())
+        {
+            return;
+        }
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, defaults.descriptorlessPipeline);
+
+        auto setPolygonMode = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
+            vkGetInstanceProcAddr(context().instance, "vkCmdSetPolygonModeEXT"));
+        assert(setPolygonMode);
+        setPolygonMode(commandBuffer, VK_POLYGON_MODE_LINE);
+
+        constexpr VkDeviceSize offset { 0 };
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &box.vertexBuffer.buffer, &offset);
+        vkCmdBindIndexBuffer(commandBuffer, box.indexBuffer.buffer, 0, box.indexType);
+
+        const auto viewProjection =
+            math::fullMatrix(renderer.camera.mats.perspective) * math::fullMatrix(renderer.camera.mats.view);
+        for (const auto& [id, request] : pending)
+        {
+            // the cube spans [-1, 1]
+            const auto model = math::Translation { request.translation } * math::Scaling<> { 0.5f * request.extent };
+            const Defaults::NodePushBlock pushBlock {
+                .matrix            = viewProjection * math::fullMatrix(model),
+                .vertexStageFlag   = 0,
+                .fragmentStageFlag = 0,
+            };
+            vkCmdPushConstants(commandBuffer, defaults.descriptorlessPipelineLayout,
+                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pushBlock),
+                               &pushBlock);
+            vkCmdDrawIndexed(commandBuffer, box.indexCount, 1, 0, 0, 0);
+        }
+    }
+
+    // stops the loading thread once its current load is done, so that no more work is submitted to the device
+    void stop()
+    {
+        worker.request_stop();
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    // requests still loading
+    Size pendingCount() const
+    {
+        return pending.size();
+    }
+
+    // the published assets, which the streamer owns
+    std::vector<std::unique_ptr<asset::Asset>> assets;
+
+private:
+    struct Loaded
+    {
+        Size                                  id;
+        std::unique_ptr<asset::Asset>         asset;
+        std::unique_ptr<Renderer::Renderable> renderable;
+        std::exception_ptr                    error;
+    };
+
+    const Defaults& defaults;
+    Renderer&       renderer;
+    const double    budget;  // seconds of publishing per frame
+    const Command   command;
+    const Model     box;
+
+    // of the render thread
+    Size                                  nextId { 0 };
+    std::vector<std::pair<Size, Request>> pending;
+
+    std::mutex                           mutex;
+    std::condition_variable_any          requested;  // a request may be taken
+    std::deque<std::pair<Size, Request>> requests;
+    std::deque<Loaded>                   loaded;
+
+    // last, so that the worker is stopped and joined before the rest is destroyed
+    std::jthread worker;
+
+    // the second queue of the graphics family if there is one, else the render loop's
+    static uint32_t streamingQueueIndex()
+    {
+        return context().physicalDevice.graphicsQueueCount > 1 ? 1 : 0;
+    }
+
+    void work(const std::stop_token stop)
+    {
+        while (true)
+        {
+            std::pair<Size, Request> next;
+            {
+                std::unique_lock lock { mutex };
+                if (!requested.wait(lock, stop, [&] { return !requests.empty(); }))
+                {
+                    return;
+                }
+                next = std::move(requests.front());
+                requests.pop_front();
+            }
+
+            auto& [id, request] = next;
+            Loaded done { id, nullptr, nullptr, nullptr };
+            try
+            {
+                done.asset = std::make_unique<asset::Asset>(command, defaults,
+                                                            asset::GltfAsset { request.name, request.path });
+                done.asset->activate(request.translation);
+                done.renderable = renderer.createRenderable(*done.asset);
+            }
+            catch (...)
+            {
+                done.error = std::current_exception();
+            }
+
+            {
+                const std::lock_guard lock { mutex };
+                loaded.push_back(std::move(done));
+            }
+        }
+    }
+
+    void report(const Size id, const std::exception_ptr error) const
+    {
+        const auto request =
+            std::find_if(pending.begin(), pending.end(), [&](const auto& job) { return job.first == id; });
+        assert(request != pending.end());
+        try
+        {
+            std::rethrow_exception(error);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "\033[1;33m[surge of WARNING]\033[0m Streaming " << request->second.name
+                      << " failed: " << e.what() << std::endl;
+        }
+        catch (...)
+        {
+            std::cerr << "\033[1;33m[surge of WARNING]\033[0m Streaming " << request->second.name << " failed"
+                      << std::endl;
+        }
+    }
+};
+
+}  // namespace surge
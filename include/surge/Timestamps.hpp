@@ -0,0 +1,102 @@
+#pragma once
+
+#include "surge/Context.hpp"
+
+#include <vector>
+
+namespace surge
+{
+
+// gpu time spent per pass, measured with a pair of timestamps
+// every frame in flight owns its own range of queries, which is read back when the frame comes around again; its
+// fence has been waited on by then, so reading never stalls and an unavailable query means the pass was skipped
+class Timestamps
+{
+public:
+    Timestamps(const uint32_t passCount, const uint32_t frameCount)
+        : passCount { passCount }
+        , frameCount { frameCount }
+        , pool { context().create(VkQueryPoolCreateInfo {
+              .sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+              .pNext              = nullptr,
+              .flags              = {},
+              .queryType          = VK_QUERY_TYPE_TIMESTAMP,
+              .queryCount         = 2 * passCount * frameCount,
+              .pipelineStatistics = {},
+          }) }
+        , milliseconds(passCount, 0.0)
+        , frame { 0 }
+        , recorded(frameCount, false)
+    {
+    }
+
+    ~Timestamps()
+    {
+        context().destroy(pool);
+    }
+
+    // collects the results of the frame that used the same queries before and resets them; outside of rendering
+    void begin(const VkCommandBuffer commandBuffer)
+    {
+        frame = (frame + 1) % frameCount;
+        if (recorded.at(frame))
+        {
+            collect();
+        }
+        vkCmdResetQueryPool(commandBuffer, pool, firstQuery(), 2 * passCount);
+        recorded.at(frame) = true;
+    }
+
+    void start(const VkCommandBuffer commandBuffer, const uint32_t pass) const
+    {
+        assert(pass < passCount);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool, firstQuery() + 2 * pass);
+    }
+
+    void stop(const VkCommandBuffer commandBuffer, const uint32_t pass) const
+    {
+        assert(pass < passCount);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pool, firstQuery() + 2 * pass + 1);
+    }
+
+    const uint32_t passCount;
+    const uint32_t frameCount;
+    VkQueryPool    pool;
+
+    // per pass, of the latest collected frame
+    std::vector<double> milliseconds;
+
+private:
+    uint32_t          frame;
+    std::vector<bool> recorded;
+
+    uint32_t firstQuery() const
+    {
+        return 2 * passCount * frame;
+    }
+
+    void collect()
+    {
+        // value and availability per query
+        std::vector<uint64_t> results(2 * 2 * passCount);
+        const auto            result =
+            vkGetQueryPoolResults(context().device, pool, firstQuery(), 2 * passCount,
+                                  results.size() * sizeof(uint64_t), results.data(), 2 * sizeof(uint64_t),
+                                  VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if (result != VK_SUCCESS && result != VK_NOT_READY)
+        {
+            throw std::runtime_error("failed to read timestamps!");
+        }
+
+        const double nanoseconds = context().physicalDevice.timestampPeriod;
+        for (uint32_t pass = 0; pass < passCount; ++pass)
+        {
+            const auto start     = results.at(4 * pass + 0);
+            const auto stop      = results.at(4 * pass + 2);
+            const auto available = results.at(4 * pass + 1) && results.at(4 * pass + 3);
+            milliseconds.at(pass) = available ? 1e-6 * nanoseconds * static_cast<double>(stop - start) : 0.0;
+        }
+    }
+};
+
+}  // namespace surge
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "surge/types.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace surge
+{
+
+// worker threads running tasks in submission order; the shared pool serves every WorkQueue, so that loads running
+// at the same time do not each spawn threads of their own
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(const Size count)
+    {
+        workers.reserve(count);
+        for (Size i = 0; i < count; ++i)
+        {
+            workers.emplace_back([this](const std::stop_token stop) { work(stop); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static ThreadPool& shared()
+    {
+        static ThreadPool pool { threadCount() };
+        return pool;
+    }
+
+    // workers besides the calling thread, which takes the results
+    static Size threadCount()
+    {
+        return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    // tasks must not throw
+    void submit(Task task)
+    {
+        {
+            const std::lock_guard lock { mutex };
+            tasks.push_back(std::move(task));
+        }
+        available.notify_one();
+    }
+
+private:
+    std::mutex                  mutex;
+    std::condition_variable_any available;  // a task may start
+    std::deque<Task>            tasks;
+
+    // last, so that the workers are stopped and joined before the rest is destroyed
+    std::vector<std::jthread> workers;
+
+    void work(const std::stop_token stop)
+    {
+        while (true)
+        {
+            Task task;
+            {
+                std::unique_lock lock { mutex };
+                if (!available.wait(lock, stop, [&] { return !tasks.empty(); }))
+                {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+};
+
+// runs jobs on the threads of a pool and hands their results back in completion order; at most window jobs are
+// submitted and not taken yet, which bounds the memory held by results in flight
+template<typename Result>
+class WorkQueue
+{
+public:
+    using Job = std::function<Result()>;
+
+    explicit WorkQueue(std::vector<Job> jobs, const Size window = 2 * ThreadPool::threadCount(),
+                       ThreadPool& pool = ThreadPool::shared())
+        : jobs { std::move(jobs) }
+        , window { std::max<Size>(window, 1) }
+        , pool { pool }
+    {
+        const std::lock_guard lock { mutex };
+        while (next < this->jobs.size() && next < this->window)
+        {
+            submit();
+        }
+    }
+
+    WorkQueue(const WorkQueue&)            = delete;
+    WorkQueue& operator=(const WorkQueue&) = delete;
+
+    // waits for the jobs already submitted, which refer to the queue
+    ~WorkQueue()
+    {
+        std::unique_lock lock { mutex };
+        completion.wait(lock, [&] { return running == 0; });
+    }
+
+    // whether every result was taken
+    bool empty() const
+    {
+        return taken == jobs.size();
+    }
+
+    // blocks until a job completes, returning its index and its result; rethrows what the job threw
+    std::pair<Size, Result> take()
+    {
+        std::unique_lock lock { mutex };
+        completion.wait(lock, [&] { return !completed.empty(); });
+        auto [index, result, error] = std::move(completed.front());
+        completed.pop_front();
+        ++taken;
+        if (next < jobs.size())
+        {
+            submit();
+        }
+        lock.unlock();
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        return { index, std::move(result.value()) };
+    }
+
+private:
+    struct Completed
+    {
+        Size                  index;
+        std::optional<Result> result;
+        std::exception_ptr    error;
+    };
+
+    const std::vector<Job> jobs;
+    const Size             window;
+    ThreadPool&            pool;
+
+    std::mutex              mutex;
+    std::condition_variable completion;  // a result may be taken, or a job finished
+    Size                    next { 0 };
+    Size                    running { 0 };  // submitted and not finished yet
+    Size                    taken { 0 };
+    std::deque<Completed>   completed;
+
+    // with the mutex held
+    void submit()
+    {
+        const auto index = next++;
+        ++running;
+        pool.submit([this, index] { run(index); });
+    }
+
+    void run(const Size index)
+    {
+        Completed done { index, std::nullopt, nullptr };
+        try
+        {
+            done.result.emplace(jobs[index]());
+        }
+        catch (...)
+        {
+            done.error = std::current_exception();
+        }
+
+        // notified with the mutex held, as the queue may be destroyed as soon as it is released
+        const std::lock_guard lock { mutex };
+        completed.push_back(std::move(done));
+        --running;
+        completion.notify_all();
+    }
+};
+
+}  // namespace surge
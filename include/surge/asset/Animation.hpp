@@ -1,6 +1,11 @@
 #pragma once
 
-#include "surge/asset/Node.hpp"
+#include "surge/asset/Pose.hpp"
+#include "surge/asset/QuantizedTrack.hpp"
+
+#include <array>
+#include <cmath>
+#include <numeric>
 
 namespace surge::asset
 {
@@ -18,8 +23,36 @@ public:
             weights
         };
         Path     path;
-        Node*    node;
+        uint32_t nodeIndex;
         uint32_t samplerIndex;
+        uint32_t target { 0 };  // first of the four morph targets a weights channel drives
+    };
+
+    // largest component difference, up to the sign for quaternions
+    static float distance(const math::Vector<4>& x, const math::Vector<4>& y, const bool spherical)
+    {
+        float e { 0 }, f { 0 };
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            e = std::max(e, std::abs(x[i] - y[i]));
+            f = std::max(f, std::abs(x[i] + y[i]));
+        }
+        return spherical ? std::min(e, f) : e;
+    }
+
+    // weighted sum of up to four output elements; every interpolation mode reduces to this form so all channels
+    // share the same branch-free kernel
+    struct Blend
+    {
+        std::array<uint32_t, 4> keys;
+        math::Vector<4>         weights;
+    };
+
+    // output elements referenced by a blend, decoded
+    struct Keys
+    {
+        std::array<uint32_t, 4>        indices { ~0u, ~0u, ~0u, ~0u };
+        std::array<math::Vector<4>, 4> values;
     };
 
     struct Sampler
@@ -30,9 +63,158 @@ public:
             step,
             cubicspline
         };
-        Interpolation                interpolation;
-        std::vector<float>           inputs;
-        std::vector<math::Vector<4>> outputs;
+        Interpolation                 interpolation;
+        std::vector<float>            inputs;
+        std::vector<math::Vector<4>>  outputs;
+        std::optional<QuantizedTrack> quantized;  // replaces outputs once compressed
+
+        math::Vector<4> output(const std::size_t index) const
+        {
+            return quantized ? quantized->decode(index) : outputs[index];
+        }
+
+        std::size_t bytes() const
+        {
+            return sizeof(float) * inputs.size() + sizeof(math::Vector<4>) * outputs.size() +
+                   (quantized ? quantized->bytes() : 0);
+        }
+
+        // drops keys that interpolating their kept neighbours reproduces within tolerance; a kept key at least every
+        // maxSpan keys bounds the keys checked per step, so that long tracks reduce in linear time
+        void reduce(const float tolerance, const bool spherical, const std::size_t maxSpan = 32)
+        {
+            if (inputs.size() < 3 || interpolation == Interpolation::cubicspline)
+            {
+                return;
+            }
+
+            const auto reconstructs = [&](const std::size_t first, const std::size_t last)
+            {
+                for (auto k = first + 1; k < last; ++k)
+                {
+                    const auto a = (inputs[k] - inputs[first]) / (inputs[last] - inputs[first]);
+                    const auto& x = outputs[first];
+                    const auto& y = outputs[last];
+                    const auto  v = interpolation == Interpolation::step ? x :
+                                    spherical ? math::Vector<4> { math::normalize(math::fastSlerp<float>(x, y, a)) } :
+                                                math::lerp(x, y, a);
+                    if (distance(v, outputs[k], spherical) > tolerance)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            std::vector<std::size_t> kept { 0 };
+            for (std::size_t last = 2; last < inputs.size(); ++last)
+            {
+                if (last - kept.back() > maxSpan || !reconstructs(kept.back(), last))
+                {
+                    kept.push_back(last - 1);
+                }
+            }
+            kept.push_back(inputs.size() - 1);
+
+            std::vector<float>           reducedInputs;
+            std::vector<math::Vector<4>> reducedOutputs;
+            reducedInputs.reserve(kept.size());
+            reducedOutputs.reserve(kept.size());
+            for (const auto k : kept)
+            {
+                reducedInputs.push_back(inputs[k]);
+                reducedOutputs.push_back(outputs[k]);
+            }
+            inputs  = std::move(reducedInputs);
+            outputs = std::move(reducedOutputs);
+        }
+
+        void compress(const float tolerance, const bool spherical)
+        {
+            if (quantized)
+            {
+                return;
+            }
+            // tangents of cubic rotations are not unit quaternions
+            if (spherical && interpolation == Interpolation::cubicspline)
+            {
+                return;
+            }
+            // the tolerance bounds the dropped keys and the rounding of the kept ones together; a track whose rounding
+            // alone exceeds it is reduced but stays in floats
+            const auto rounding = spherical ? QuantizedTrack::quaternionError : QuantizedTrack::fixedError(outputs);
+            if (rounding > tolerance)
+            {
+                reduce(tolerance, spherical);
+                return;
+            }
+            reduce(tolerance - rounding, spherical);
+            quantized = spherical ? QuantizedTrack::encodeQuaternions(outputs) : QuantizedTrack::encodeFixed(outputs);
+            outputs.clear();
+            outputs.shrink_to_fit();
+        }
+
+        // returns the number of keys not later than time, stepping forward from a previous cursor;
+        // playback moves by small increments so this is O(1) amortised, backward jumps fall back to a binary search
+        std::size_t seek(std::size_t cursor, const float time) const
+        {
+            if (cursor > inputs.size() || (cursor > 0 && inputs[cursor - 1] > time))
+            {
+                return std::distance(inputs.begin(), std::upper_bound(inputs.begin(), inputs.end(), time));
+            }
+            while (cursor < inputs.size() && inputs[cursor] <= time)
+            {
+                ++cursor;
+            }
+            return cursor;
+        }
+
+        // cubic spline outputs are stored as (in-tangent, value, out-tangent) triplets
+        uint32_t value(const std::size_t key) const
+        {
+            return static_cast<uint32_t>(interpolation == Interpolation::cubicspline ? 3 * key + 1 : key);
+        }
+
+        Blend blend(const std::size_t cursor, const float time) const
+        {
+            assert(!inputs.empty());
+            if (cursor == 0 || cursor >= inputs.size())
+            {
+                const auto key = value(cursor == 0 ? 0 : inputs.size() - 1);
+                return { { key, key, key, key }, { 1, 0, 0, 0 } };
+            }
+
+            const auto k  = cursor - 1;
+            const auto dt = inputs[k + 1] - inputs[k];
+            const auto a  = (time - inputs[k]) / dt;
+            switch (interpolation)
+            {
+            case Interpolation::step:
+            {
+                const auto key = value(k);
+                return { { key, key, key, key }, { 1, 0, 0, 0 } };
+            }
+            case Interpolation::linear:
+            {
+                const auto x = value(k);
+                const auto y = value(k + 1);
+                return { { x, y, x, y }, { 1 - a, a, 0, 0 } };
+            }
+            case Interpolation::cubicspline:
+            {
+                // Hermite basis, tangents are scaled by the key interval (glTF 2.0, Appendix C)
+                const auto a2 = a * a;
+                const auto a3 = a2 * a;
+                const auto x  = value(k);
+                const auto y  = value(k + 1);
+                return {
+                    { x, x + 1, y, y - 1 },
+                    { 2 * a3 - 3 * a2 + 1, (a3 - 2 * a2 + a) * dt, -2 * a3 + 3 * a2, (a3 - a2) * dt },
+                };
+            }
+            }
+            throw std::runtime_error("unsupported interpolation");
+        }
     };
 
     std::string          name;
@@ -40,68 +222,352 @@ public:
     float                end   = std::numeric_limits<float>::min();
     std::vector<Sampler> samplers;
     std::vector<Channel> channels;
+    // channels animating leaf joints come last, so that level of detail can drop them as a tail
+    std::size_t firstLeafChannel { std::numeric_limits<std::size_t>::max() };
+
+    struct Compression
+    {
+        float       tolerance;
+        std::size_t rawBytes;
+        std::size_t bytes;
+    };
+    std::optional<Compression> compression;
+
+    struct Baked
+    {
+        float                        rate;
+        std::size_t                  frameCount;
+        float                        error { 0 };
+        std::vector<math::Vector<4>> frames;  // frame major, one value per channel
+
+        float time(const std::size_t frame, const float end) const
+        {
+            return std::min(frame / rate, end);
+        }
+
+        void interpolate(const std::size_t frame, const float a, std::vector<math::Vector<4>>& values) const
+        {
+            const auto  count = values.size();
+            const auto* x     = frames.data() + frame * count;
+            const auto* y     = x + count;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                values[i] = (1 - a) * x[i] + a * y[i];
+            }
+        }
+
+        std::size_t bytes() const
+        {
+            return sizeof(math::Vector<4>) * frames.size();
+        }
+    };
+    std::optional<Baked> baked;
+    std::optional<float> refusedBakeError;  // of the densest table, when none met the error budget
+
+    enum class Blending
+    {
+        mix,       // weighted average with the other mixed clips
+        additive,  // difference to the rest pose, layered on top of the mixed clips
+    };
 
     struct State
     {
-        bool  active { true };
-        float progress { 0 };
+        bool                         active { true };
+        float                        progress { 0 };
+        float                        weight { 1 };
+        Blending                     blending { Blending::mix };
+        std::vector<std::size_t>     cursors;  // one per sampler, shared by all channels referencing it
+        std::vector<Blend>           blends;   // one per channel
+        std::vector<Keys>            keys;     // one per channel
+        std::vector<math::Vector<4>> values;   // one per channel
+        bool                         skipLeafChannels { false };
+
+        // linearly interpolated rotations, gathered for the batched slerp weights
+        struct Slerps
+        {
+            std::vector<std::size_t> channels;
+            std::vector<float>       cosines;
+            std::vector<float>       parameters;
+            std::vector<float>       firstWeights;
+            std::vector<float>       secondWeights;
+        } slerps;
     };
     mutable State state;
 
-    void update(const double elapsedTime)
+    std::size_t activeChannels(const State& sampling) const
+    {
+        return sampling.skipLeafChannels ? std::min(firstLeafChannel, channels.size()) : channels.size();
+    }
+
+    std::size_t bytes() const
+    {
+        return std::accumulate(samplers.begin(), samplers.end(), baked ? baked->bytes() : std::size_t { 0 },
+                               [](const std::size_t total, const Sampler& sampler) { return total + sampler.bytes(); });
+    }
+
+    void compress(const float tolerance)
+    {
+        assert(!baked);
+        const auto rawBytes = bytes();
+        for (const auto& channel : channels)
+        {
+            // fixed point tracks hold three components, weights use all four lanes
+            if (channel.path != Channel::Path::weights)
+            {
+                samplers.at(channel.samplerIndex).compress(tolerance, channel.path == Channel::Path::rotation);
+            }
+        }
+        state.cursors.clear();
+        state.keys.clear();
+        compression = Compression { tolerance, rawBytes, bytes() };
+    }
+
+    void advance(const double elapsedTime) const
     {
         state.progress += elapsedTime;
         if (state.progress > end)
         {
             state.progress -= end;
+            std::fill(state.cursors.begin(), state.cursors.end(), 0);
         }
-        for (const auto& channel : channels)
+
+        if (!baked)
         {
-            const auto& sampler    = samplers.at(channel.samplerIndex);
-            const auto  lowerBound = std::lower_bound(sampler.inputs.begin(), sampler.inputs.end(), state.progress);
-            const auto  index      = std::distance(sampler.inputs.begin(), lowerBound - 1);
-            if (index < 0 || index >= static_cast<std::ptrdiff_t>(sampler.inputs.size() - 1))
-            {
-                continue;
-            }
+            seek(state);
+        }
+    }
 
-            assert(sampler.inputs.at(index) <= state.progress && state.progress < sampler.inputs.at(index + 1));
-            const auto a =
-                (state.progress - sampler.inputs.at(index)) / (sampler.inputs.at(index + 1) - sampler.inputs.at(index));
+    // overwrites the animated channels of pose, which is expected to hold the rest pose
+    void sample(Pose& pose) const
+    {
+        sample(state, pose);
+    }
+
+    // samples the clip at time through a sampling state of the caller, for users sharing the clip at other phases;
+    // the playback of the clip is left untouched
+    void sampleAt(const float time, State& sampling, Pose& pose) const
+    {
+        sampling.progress = time;
+        if (!baked)
+        {
+            seek(sampling);
+        }
+        sample(sampling, pose);
+    }
+
+    // overwrites the animated channels of pose at the progress of a sampling state
+    void sample(State& sampling, Pose& pose) const
+    {
+        if (baked)
+        {
+            lookup(sampling);
+        }
+        else
+        {
+            evaluate(sampling, activeChannels(sampling));
+        }
+
+        for (std::size_t i = 0; i < activeChannels(sampling); ++i)
+        {
+            const auto& channel = channels[i];
+            const auto& value   = sampling.values[i];
             switch (channel.path)
             {
             case Channel::Path::translation:
             {
-                const auto&           x4 { sampler.outputs.at(index) };
-                const auto&           y4 { sampler.outputs.at(index + 1) };
-                const math::Vector<3> x { x4.at(0), x4.at(1), x4.at(2) };
-                const math::Vector<3> y { y4.at(0), y4.at(1), y4.at(2) };
-                channel.node->state.translation = math::lerp(x, y, a);
+                pose.translations.at(channel.nodeIndex) = { value[0], value[1], value[2] };
                 break;
             }
             case Channel::Path::rotation:
             {
-                const math::Quaternion x { sampler.outputs.at(index) };
-                const math::Quaternion y { sampler.outputs.at(index) };
-                channel.node->state.rotation = math::normalize(math::slerp(x, y, a));
+                pose.rotations.at(channel.nodeIndex) = math::normalize(value);
                 break;
             }
             case Channel::Path::scale:
             {
-                const auto&           x4 { sampler.outputs.at(index) };
-                const auto&           y4 { sampler.outputs.at(index + 1) };
-                const math::Vector<3> x { x4.at(0), x4.at(1), x4.at(2) };
-                const math::Vector<3> y { y4.at(0), y4.at(1), y4.at(2) };
-                channel.node->state.scale = math::lerp(x, y, a);
+                pose.scales.at(channel.nodeIndex) = { value[0], value[1], value[2] };
                 break;
             }
             case Channel::Path::weights:
             {
-                throw std::runtime_error("unsupported");
+                auto&      weights = pose.weights.at(channel.nodeIndex);
+                const auto count   = std::min<std::size_t>(4, weights.size() - channel.target);
+                for (std::size_t k = 0; k < count; ++k)
+                {
+                    weights[channel.target + k] = value[k];
+                }
                 break;
             }
             }
         }
     }
+
+    // pre-samples the clip into a table of per-channel values, which replaces the samplers; the rate doubles until
+    // interpolating between two frames stays within the error budget, a clip still over it at maxRate keeps its
+    // samplers and returns false
+    bool bake(float rate, const float errorBudget, const float maxRate = 960)
+    {
+        assert(rate > 0);
+        assert(!baked);
+        refusedBakeError.reset();
+        const auto progress = state.progress;
+        while (true)
+        {
+            const auto frameCount = std::max<std::size_t>(2, static_cast<std::size_t>(std::ceil(end * rate)) + 1);
+            Baked      table { rate, frameCount, 0, {} };
+            table.frames.reserve(table.frameCount * channels.size());
+            for (std::size_t frame = 0; frame < table.frameCount; ++frame)
+            {
+                evaluateAt(table.time(frame, end));
+                for (std::size_t i = 0; i < channels.size(); ++i)
+                {
+                    auto value = state.values[i];
+                    if (channels[i].path == Channel::Path::rotation)
+                    {
+                        value = math::normalize(value);
+                        // keep consecutive frames on the same hemisphere so that lookups can nlerp
+                        if (frame > 0 && math::dot(value, table.frames[table.frames.size() - channels.size()]) < 0)
+                        {
+                            value = -value;
+                        }
+                    }
+                    table.frames.push_back(value);
+                }
+            }
+
+            std::vector<math::Vector<4>> interpolated(channels.size());
+            for (std::size_t frame = 0; frame + 1 < table.frameCount; ++frame)
+            {
+                for (const auto a : { 0.25f, 0.5f, 0.75f })
+                {
+                    const auto time = math::lerp(table.time(frame, end), table.time(frame + 1, end), a);
+                    table.interpolate(frame, a, interpolated);
+                    evaluateAt(time);
+                    for (std::size_t i = 0; i < channels.size(); ++i)
+                    {
+                        const auto spherical = channels[i].path == Channel::Path::rotation;
+                        const auto expected  = spherical ? math::normalize(state.values[i]) : state.values[i];
+                        const auto actual    = spherical ? math::normalize(interpolated[i]) : interpolated[i];
+                        table.error          = std::max(table.error, distance(actual, expected, spherical));
+                    }
+                }
+            }
+
+            if (table.error <= errorBudget)
+            {
+                baked = std::move(table);
+                break;
+            }
+            if (2 * rate > maxRate)
+            {
+                refusedBakeError = table.error;
+                break;
+            }
+            rate *= 2;
+        }
+        state.progress = progress;
+        state.cursors.clear();
+        state.keys.clear();
+        if (baked)
+        {
+            samplers.clear();
+            samplers.shrink_to_fit();
+        }
+        return baked.has_value();
+    }
+
+private:
+    void seek(State& sampling) const
+    {
+        sampling.cursors.resize(samplers.size(), 0);
+        for (std::size_t i = 0; i < samplers.size(); ++i)
+        {
+            sampling.cursors[i] = samplers[i].seek(sampling.cursors[i], sampling.progress);
+        }
+    }
+
+    void evaluateAt(const float time) const
+    {
+        state.progress = time;
+        seek(state);
+        evaluate(state, channels.size());
+    }
+
+    void evaluate(State& sampling, const std::size_t count) const
+    {
+        // weights: the only per-mode work, scalar and cheap
+        sampling.blends.resize(channels.size());
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& channel = channels[i];
+            sampling.blends[i] =
+                samplers[channel.samplerIndex].blend(sampling.cursors[channel.samplerIndex], sampling.progress);
+        }
+
+        // keys: decoded only when a channel moves to another key interval
+        sampling.keys.resize(channels.size());
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& blend = sampling.blends[i];
+            auto&       keys  = sampling.keys[i];
+            if (keys.indices != blend.keys)
+            {
+                const auto& sampler = samplers[channels[i].samplerIndex];
+                for (std::size_t j = 0; j < 4; ++j)
+                {
+                    keys.values[j] = j > 1 && blend.keys[j] == blend.keys[j - 2] ? keys.values[j - 2] :
+                                                                                  sampler.output(blend.keys[j]);
+                }
+                keys.indices = blend.keys;
+            }
+        }
+
+        // rotations: linear weights become slerp weights on the short arc, computed for all channels in one batch
+        auto& slerps = sampling.slerps;
+        slerps.channels.clear();
+        slerps.cosines.clear();
+        slerps.parameters.clear();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (channels[i].path == Channel::Path::rotation &&
+                samplers[channels[i].samplerIndex].interpolation == Sampler::Interpolation::linear)
+            {
+                const auto& keys = sampling.keys[i].values;
+                slerps.channels.push_back(i);
+                slerps.cosines.push_back(math::dot(keys[0], keys[1]));
+                slerps.parameters.push_back(math::get<1>(sampling.blends[i].weights));
+            }
+        }
+        slerps.firstWeights.resize(slerps.channels.size());
+        slerps.secondWeights.resize(slerps.channels.size());
+        math::slerpWeights(slerps.cosines.data(), slerps.parameters.data(), slerps.firstWeights.data(),
+                           slerps.secondWeights.data(), slerps.channels.size());
+        for (std::size_t j = 0; j < slerps.channels.size(); ++j)
+        {
+            const auto second = slerps.cosines[j] < 0 ? -slerps.secondWeights[j] : slerps.secondWeights[j];
+            sampling.blends[slerps.channels[j]].weights = { slerps.firstWeights[j], second, 0, 0 };
+        }
+
+        // values: the same 4-lane multiply-add for every channel and mode
+        sampling.values.resize(channels.size());
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& weights = sampling.blends[i].weights;
+            const auto& keys    = sampling.keys[i].values;
+            sampling.values[i]  = math::get<0>(weights) * keys[0] + math::get<1>(weights) * keys[1] +
+                                 math::get<2>(weights) * keys[2] + math::get<3>(weights) * keys[3];
+        }
+    }
+
+    void lookup(State& sampling) const
+    {
+        const auto& table = baked.value();
+        const auto  frame = std::min(static_cast<std::size_t>(sampling.progress * table.rate), table.frameCount - 2);
+        const auto  t0    = table.time(frame, end);
+        const auto  t1    = table.time(frame + 1, end);
+        const auto  a     = t1 > t0 ? std::clamp((sampling.progress - t0) / (t1 - t0), 0.0f, 1.0f) : 0.0f;
+        sampling.values.resize(channels.size());
+        table.interpolate(frame, a, sampling.values);
+    }
 };
-}  // namespace surge::asset
\ No newline at end of file
+}  // namespace surge::asset
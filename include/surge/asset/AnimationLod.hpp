@@ -0,0 +1,64 @@
+#pragma once
+
+#include "surge/math/BoundingBox.hpp"
+#include "surge/math/Vector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace surge::asset
+{
+
+// picks how often an asset is animated from the share of the screen it covers
+struct AnimationLod
+{
+    // thresholds on the coverage, the projected radius over half the screen height
+    struct Settings
+    {
+        bool  enabled { true };
+        bool  interpolate { true };  // blend the two latest poses between updates instead of holding the last one
+        float everyFrame { 0.2f };
+        float everySecondFrame { 0.08f };
+        float everyFourthFrame { 0.01f };  // frozen below
+        float leafJoints { 0.05f };        // leaf joints keep their rest pose below
+    };
+
+    struct Schedule
+    {
+        bool     visible;
+        float    coverage;
+        uint32_t interval;  // frames between pose updates, 0 when frozen
+        bool     skipLeafJoints;
+    };
+
+    // bounding sphere of box placed at translation
+    static std::pair<math::Vector<3>, float> sphere(const math::BoundingBox& box, const math::Vector<3>& translation)
+    {
+        return { translation + 0.5f * (box.min + box.max), 0.5f * math::norm(box.max - box.min) };
+    }
+
+    // the interval for a bounding sphere, whose visibility the caller tests against the view frustum for many assets
+    // at once, see math::batch::intersect
+    static Schedule schedule(const Settings& settings, const bool visible, const math::Vector<3>& center,
+                             const float radius, const math::Vector<3>& eye, const math::Vector<3>& front,
+                             const float fovy)
+    {
+        const auto toCenter = center - eye;
+        const auto distance = math::norm(toCenter);
+        if (!settings.enabled || distance <= radius)
+        {
+            return { true, 1, 1, false };
+        }
+
+        const auto depth    = std::max(math::dot(toCenter, front), radius);
+        const auto coverage = visible ? std::min(radius / (depth * std::tan(0.5f * fovy)), 1.0f) : 0.0f;
+        const auto interval = coverage >= settings.everyFrame       ? 1u :
+                              coverage >= settings.everySecondFrame ? 2u :
+                              coverage >= settings.everyFourthFrame ? 4u :
+                                                                      0u;
+        return { visible, coverage, interval, coverage < settings.leafJoints };
+    }
+};
+
+}  // namespace surge::asset
@@ -6,18 +6,26 @@
 #include "surge/Defaults.hpp"
 #include "surge/Model.hpp"
 #include "surge/asset/Animation.hpp"
+#include "surge/asset/AnimationLod.hpp"
 #include "surge/asset/GltfAsset.hpp"
 #include "surge/asset/ObjAsset.hpp"
 #include "surge/asset/LoadedTexture.hpp"
 #include "surge/asset/Mesh.hpp"
 #include "surge/asset/Node.hpp"
+#include "surge/asset/Pose.hpp"
 #include "surge/asset/Scene.hpp"
 #include "surge/asset/Skin.hpp"
 
 #include "surge/geometry/Shape.hpp"
 #include "surge/geometry/Vertex.hpp"
+#include "surge/geometry/VertexLayout.hpp"
+#include "surge/math/DualQuaternion.hpp"
 
+#include <cstddef>
+#include <cstring>
+#include <functional>
 #include <numeric>
+#include <set>
 
 
 namespace surge::asset
@@ -47,6 +55,33 @@ public:
     }
 };
 
+// sparse displacements of all morph targets of an asset, read by the morphing compute pass
+class MorphTargets
+{
+public:
+    using DeltasBufferInfo = BufferInfo<VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT>;
+
+    MorphTargets(const Command& command, const std::vector<Mesh::MorphDelta>& deltas)
+        : deltaCount { static_cast<uint32_t>(deltas.size()) }
+        , deltas { deltas.size() * sizeof(Mesh::MorphDelta), DeltasBufferInfo {} }
+    {
+        command.transferBuffer(this->deltas.buffer, deltas.data(), this->deltas.size);
+    }
+
+    uint32_t deltaCount;
+    Buffer   deltas;
+};
+
+// region of the joint matrices ssbo owned by one skinned node, offset counted in matrices
+struct JointPalette
+{
+    const Node&                     node;
+    const Skin&                     skin;
+    uint32_t                        offset;
+    std::vector<math::Matrix<4, 4>> matrices;
+};
+
 class Asset
 {
 public:
@@ -62,15 +97,26 @@ public:
     std::vector<Material> materials;
 
     std::vector<Mesh> meshes;
+    math::BoundingBox bounds;  // of all meshes, in model space
 
-    VkPipelineVertexInputStateCreateInfo vertexInputState;
+    geometry::VertexLayout layout;  // of the model vertices
 
-    Model              model;
-    std::vector<Scene> scenes;
+    Model                       model;
+    LoadStatistics              loadStatistics;  // once textures and model are uploaded
+    std::optional<MorphTargets> morphTargets;
+    std::vector<Scene>          scenes;
     std::size_t        mainSceneIndex;
 
     std::vector<Skin>      skins;
     std::vector<Animation> animations;
+    Pose                   restPose;
+    mutable Pose           pose;
+    mutable Pose           clipPose;
+    mutable Pose           previousPose;  // sampled one update before pose
+
+    SkinningMethod            skinningMethod;
+    std::vector<JointPalette> jointPalettes;
+    uint32_t                  deformedVertexCount;  // model vertices, then the ranges of nodes sharing a mesh
     struct JointMatricesSSBO
     {
         Buffer                buffer;
@@ -81,15 +127,31 @@ public:
 
     struct State
     {
-        bool                            active;
-        std::vector<math::Matrix<4, 4>> jointMatrices;
+        bool            active;
+        math::Vector<3> translation { 0, 0, 0 };  // placement in the scene
+        bool            computeSkinning { true };
+        bool            depthPrePass { false };  // positions drawn to depth before shading
+        // joint matrices written to the ssbo by the latest update
+        Size uploadedBytes { 0 };
+        struct GpuTime
+        {
+            double skinning;
+            double draw;
+        } gpuTime { 0, 0 };
+
+        AnimationLod::Settings lod {};
+        AnimationLod::Schedule schedule { true, 1, 1, false };
+        uint32_t               framesSinceUpdate { 0 };
+        double                 pendingTime { 0 };  // elapsed since the latest pose update
+        bool                   posed { true };     // whether the latest update moved the nodes
     };
     mutable State state;
 
     // using UniformBufferDescr = UniformBufferDescription<VK_SHADER_STAGE_VERTEX_BIT>;
     using SSBODescr = Description<VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT, Buffer>;
 
-    Asset(const Command& command, const Defaults& defaults, const GltfAsset& gltf)
+    // the import is consumed: its cache is committed once the asset is built
+    Asset(const Command& command, const Defaults& defaults, GltfAsset&& gltf)
         : name { gltf.name }
         , path { gltf.path }
         , shader { gltf.shader() }
@@ -98,17 +160,33 @@ public:
         , materialDescriptorSetLayout { gltf.createMaterialDescriptorSetLayout() }
         , materials { gltf.createMaterials(defaults, descriptorPool, materialDescriptorSetLayout, textures) }
         , meshes { gltf.createMeshes(defaults, materials) }
-        , vertexInputState { geometry::createVertexInputState<GltfAsset::Vertex>() }
+        , bounds { createBounds(meshes) }
+        , layout { gltf.layout }
         , model { gltf.createModel(command, meshes) }
+        , loadStatistics { gltf.loadStatistics }
+        , morphTargets { createMorphTargets(command, gltf.createMorphDeltas(meshes)) }
         , scenes { gltf.createScenes(meshes) }
         , mainSceneIndex { gltf.mainSceneIndex() }
-        , skins { gltf.createSkins(scenes.front().nodesLut) }
-        , animations { gltf.createAnimations(scenes.front().nodesLut) }
+        , skins { gltf.createSkins(mainScene().nodesLut) }
+        , animations { gltf.createAnimations(mainScene().nodesLut) }
+        , restPose { mainScene().nodesLut }
+        , pose { restPose }
+        , clipPose { restPose }
+        , previousPose { restPose }
+        , skinningMethod { gltf.animationOptions.skinning }
+        , jointPalettes { createJointPalettes(mainScene(), skins) }
+        , deformedVertexCount { createDeformedRanges(mainScene(), model.vertexCount) }
         // , jointMatricesSSBO { std::in_place, computeJointMatricesSize(skins), descriptorPool }
-        , jointMatricesSSBO { createJointMatricesSSBO(descriptorPool, skins) }
-        , state { false, std::vector<math::Matrix<4, 4>> {} }
+        , jointMatricesSSBO { createJointMatricesSSBO(descriptorPool, jointPalettes, jointBytes(skinningMethod)) }
+        , state { false }
     {
         assert(scenes.size() > 0);
+        // clips are blended rather than overwriting each other, so only the first one starts playing
+        for (std::size_t i = 1; i < animations.size(); ++i)
+        {
+            animations[i].state.active = false;
+        }
+        gltf.cache.commit();
     }
 
     Asset(const Command& command, const Defaults& defaults, const ObjAsset& obj)
@@ -120,14 +198,24 @@ public:
         , materialDescriptorSetLayout { obj.createMaterialDescriptorSetLayout() }
         , materials { obj.createMaterials(defaults, descriptorPool, materialDescriptorSetLayout, textures) }
         , meshes { obj.createMesh(defaults, materials) }
-        , vertexInputState { geometry::createVertexInputState<ObjAsset::Vertex>() }
+        , bounds { createBounds(meshes) }
+        , layout { ObjAsset::Vertex {} }
         , model { obj.createModel(command, meshes.front()) }
+        , loadStatistics { .vertexCacheBefore = obj.vertexCacheBefore, .vertexCacheAfter = obj.vertexCacheAfter }
+        , morphTargets {}
         , scenes { obj.createScene(meshes.front()) }
         , mainSceneIndex { 0 }
         , skins {}
         , animations {}
+        , restPose { mainScene().nodesLut }
+        , pose { restPose }
+        , clipPose { restPose }
+        , previousPose { restPose }
+        , skinningMethod { SkinningMethod::linear }
+        , jointPalettes {}
+        , deformedVertexCount { createDeformedRanges(mainScene(), model.vertexCount) }
         , jointMatricesSSBO {}
-        , state { false, std::vector<math::Matrix<4, 4>> {} }
+        , state { false }
     {
         assert(scenes.size() > 0);
     }
@@ -138,17 +226,106 @@ public:
         context().destroy(descriptorPool);
     }
 
+    void schedule(const AnimationLod::Schedule& schedule) const
+    {
+        state.schedule = schedule;
+    }
+
+    // places the asset and turns it on along with the nodes of its main scene, two levels deep
+    void activate(const math::Vector<3>& translation)
+    {
+        state.translation = translation;
+        state.active      = true;
+        for (auto& node : mainScene().nodes)
+        {
+            node.state.active = true;
+            for (auto& child : node.children)
+            {
+                child.state.active = true;
+            }
+        }
+    }
+
     void update(const double elapsedTime)
     {
-        for (auto& animation : animations)
+        state.uploadedBytes = 0;
+        // frozen: time stands still until the asset is worth animating again
+        state.posed = state.schedule.interval > 0 && updatePose(elapsedTime);
+        if (state.posed)
         {
-            animation.update(elapsedTime);
+            updateJoints();
         }
-        for (const auto& scene : scenes)
+    }
+
+    // resamples the clips every scheduled interval; in between, either holds the nodes or blends them towards the
+    // latest pose, one interval behind; returns whether the nodes may have moved
+    bool updatePose(const double elapsedTime)
+    {
+        const auto isActive = [](const Animation& animation) { return animation.state.active; };
+        if (std::none_of(animations.begin(), animations.end(), isActive))
+        {
+            return true;
+        }
+
+        const auto interval    = state.schedule.interval;
+        const auto interpolate = state.lod.interpolate && interval > 1;
+        state.pendingTime += elapsedTime;
+        if (++state.framesSinceUpdate >= interval)
+        {
+            for (const auto& animation : animations)
+            {
+                animation.state.skipLeafChannels = state.schedule.skipLeafJoints;
+            }
+            std::swap(previousPose, pose);
+            samplePose(state.pendingTime);
+            state.framesSinceUpdate = 0;
+            state.pendingTime       = 0;
+        }
+        else if (!interpolate)
+        {
+            return false;
+        }
+
+        if (!interpolate)
+        {
+            pose.apply(mainScene().nodesLut);
+            return true;
+        }
+        const auto a = static_cast<float>(state.framesSinceUpdate) / interval;
+        clipPose.clear();
+        clipPose.accumulate(previousPose, previousPose, 1 - a);
+        clipPose.accumulate(pose, previousPose, a);
+        clipPose.resolve(previousPose, 1);
+        clipPose.apply(mainScene().nodesLut);
+        return true;
+    }
+
+    // samples every active clip into its own pose and blends them into pose
+    void samplePose(const double elapsedTime)
+    {
+        pose.clear();
+        float totalWeight { 0 };
+        for (const auto& animation : animations)
+        {
+            if (animation.state.active && animation.state.blending == Animation::Blending::mix)
+            {
+                animation.advance(elapsedTime);
+                clipPose = restPose;
+                animation.sample(clipPose);
+                pose.accumulate(clipPose, restPose, animation.state.weight);
+                totalWeight += animation.state.weight;
+            }
+        }
+        pose.resolve(restPose, totalWeight);
+
+        for (const auto& animation : animations)
         {
-            for (const auto& node : scene.nodes)
+            if (animation.state.active && animation.state.blending == Animation::Blending::additive)
             {
-                updateJoints(node);
+                animation.advance(elapsedTime);
+                clipPose = restPose;
+                animation.sample(clipPose);
+                pose.add(clipPose, restPose, animation.state.weight);
             }
         }
     }
@@ -213,30 +390,64 @@ public:
     //     }
     // }
 
-    void updateJoints(const Node& node)
+    // recomputes every palette, but only writes the ones that changed to the ssbo
+    // adds what it writes to state.uploadedBytes, which update resets every frame
+    void updateJoints()
     {
-        if (node.skinIndex)
+        for (auto& palette : jointPalettes)
         {
-            const auto& skin = skins.at(node.skinIndex.value());
-            state.jointMatrices.clear();
-            state.jointMatrices.reserve(skin.joints.size());
+            const auto inverse = math::inverse(palette.node.globalMatrix());
 
-            const auto inverse = math::inverse(node.globalMatrix());
+            jointMatrices.clear();
+            for (const auto& [jointNode, inverseBindMatrix] : palette.skin.joints)
+            {
+                jointMatrices.emplace_back(math::fullMatrix(inverse * jointNode.globalMatrix() * inverseBindMatrix));
+            }
 
-            for (const auto& [jointNode, inverseBindMatrix] : skin.joints)
+            // bitwise, so that any motion at all gets uploaded
+            const auto bytes = jointMatrices.size() * sizeof(math::Matrix<4, 4>);
+            if (palette.matrices.size() == jointMatrices.size() &&
+                memcmp(palette.matrices.data(), jointMatrices.data(), bytes) == 0)
             {
-                state.jointMatrices.emplace_back(inverse * jointNode.globalMatrix() * inverseBindMatrix);
+                continue;
             }
+            std::swap(jointMatrices, palette.matrices);
 
             assert(jointMatricesSSBO);
-            memcpy(jointMatricesSSBO->buffer.mapped, state.jointMatrices.data(),
-                   state.jointMatrices.size() * sizeof(math::Matrix<4, 4>));
+            auto* const palettes = static_cast<std::byte*>(jointMatricesSSBO->buffer.mapped);
+            if (skinningMethod == SkinningMethod::dualQuaternion)
+            {
+                jointDualQuaternions.clear();
+                for (const auto& matrix : palette.matrices)
+                {
+                    jointDualQuaternions.push_back(math::toDualQuaternion(matrix));
+                }
+                const auto dualQuaternionBytes = jointDualQuaternions.size() * sizeof(math::DualQuaternion<>);
+                memcpy(palettes + palette.offset * sizeof(math::DualQuaternion<>), jointDualQuaternions.data(),
+                       dualQuaternionBytes);
+                state.uploadedBytes += dualQuaternionBytes;
+            }
+            else
+            {
+                memcpy(palettes + palette.offset * sizeof(math::Matrix<4, 4>), palette.matrices.data(), bytes);
+                state.uploadedBytes += bytes;
+            }
         }
+    }
 
-        for (const auto& child : node.children)
-        {
-            updateJoints(child);
-        }
+    // per joint in the ssbo
+    static Size jointBytes(const SkinningMethod skinningMethod)
+    {
+        return skinningMethod == SkinningMethod::dualQuaternion ? sizeof(math::DualQuaternion<>) :
+                                                                  sizeof(math::Matrix<4, 4>);
+    }
+
+    // joints of all palettes
+    uint32_t jointCount() const
+    {
+        return jointPalettes.empty() ? 0 :
+                                       jointPalettes.back().offset +
+                                           static_cast<uint32_t>(jointPalettes.back().skin.joints.size());
     }
 
     const auto& mainScene() const
@@ -256,12 +467,103 @@ private:
                                                             { return total + skin.joints.size(); });
     }
 
-    static std::optional<ShaderStorageBufferObject> createJointMatricesSSBO(const VkDescriptorPool   descriptorPool,
-                                                                            const std::vector<Skin>& skins)
+    // scratch for the palette being updated
+    std::vector<math::Matrix<4, 4>>     jointMatrices;
+    std::vector<math::DualQuaternion<>> jointDualQuaternions;
+
+    static math::BoundingBox createBounds(const std::vector<Mesh>& meshes)
+    {
+        constexpr auto    max = std::numeric_limits<float>::max();
+        math::BoundingBox bounds { { max, max, max }, { -max, -max, -max } };
+        for (const auto& mesh : meshes)
+        {
+            for (const auto& primitive : mesh.primitives)
+            {
+                for (std::size_t i = 0; i < 3; ++i)
+                {
+                    bounds.min[i] = std::min(bounds.min[i], primitive.bb.min[i]);
+                    bounds.max[i] = std::max(bounds.max[i], primitive.bb.max[i]);
+                }
+            }
+        }
+        return bounds.min[0] <= bounds.max[0] ? bounds : math::BoundingBox { { 0, 0, 0 }, { 0, 0, 0 } };
+    }
+
+    // one palette per skinned node of the drawn scene, the only one whose nodes get deformed ranges, so that nodes
+    // sharing a skin still pose independently; the node keeps its offset
+    static std::vector<JointPalette> createJointPalettes(Scene& scene, const std::vector<Skin>& skins)
+    {
+        std::vector<JointPalette> palettes;
+        uint32_t                  offset { 0 };
+
+        const std::function<void(Node&)> allocate = [&](Node& node)
+        {
+            if (node.skinIndex)
+            {
+                const auto& skin = skins.at(node.skinIndex.value());
+                palettes.push_back(JointPalette { node, skin, offset, {} });
+                node.jointOffset = offset;
+                offset += static_cast<uint32_t>(skin.joints.size());
+            }
+            for (auto& child : node.children)
+            {
+                allocate(child);
+            }
+        };
+        for (auto& node : scene.nodes)
+        {
+            allocate(node);
+        }
+        return palettes;
+    }
+
+    // one range of deformed vertices per node with a mesh, so that nodes sharing a mesh deform independently: the
+    // first node of a mesh takes the range of the mesh in the model, the others get theirs past the model vertices;
+    // returns the deformed vertex count
+    static uint32_t createDeformedRanges(Scene& scene, const uint32_t modelVertexCount)
+    {
+        uint32_t              count { modelVertexCount };
+        std::set<const Mesh*> placed;
+
+        const std::function<void(Node&)> allocate = [&](Node& node)
+        {
+            if (node.mesh)
+            {
+                if (placed.insert(node.mesh).second)
+                {
+                    node.deformedVertex = node.mesh->firstVertex();
+                }
+                else
+                {
+                    node.deformedVertex = count;
+                    count += node.mesh->vertexCount();
+                }
+            }
+            for (auto& child : node.children)
+            {
+                allocate(child);
+            }
+        };
+        for (auto& node : scene.nodes)
+        {
+            allocate(node);
+        }
+        return count;
+    }
+
+    static std::optional<MorphTargets> createMorphTargets(const Command&                        command,
+                                                          const std::vector<Mesh::MorphDelta>& deltas)
+    {
+        return deltas.empty() ? std::optional<MorphTargets> {} :
+                                std::optional<MorphTargets> { std::in_place, command, deltas };
+    }
+
+    static std::optional<ShaderStorageBufferObject>
+        createJointMatricesSSBO(const VkDescriptorPool descriptorPool, const std::vector<JointPalette>& palettes,
+                                const Size jointBytes)
     {
-        const auto size { sizeof(math::Matrix<4, 4>) * std::accumulate(skins.begin(), skins.end(), 0,
-                                                                       [](const Size total, const Skin& skin)
-                                                                       { return total + skin.joints.size(); }) };
+        const auto size { jointBytes *
+                          (palettes.empty() ? 0 : palettes.back().offset + palettes.back().skin.joints.size()) };
 
         return size > 0 ? std::optional<ShaderStorageBufferObject> { std::in_place, size, descriptorPool } :
                           std::optional<ShaderStorageBufferObject> {};
@@ -0,0 +1,582 @@
+#pragma once
+
+#include "surge/asset/MappedFile.hpp"
+#include "surge/types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <random>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace surge::asset
+{
+
+// FNV-1a, 64 bits
+constexpr UInt64 fnv1a(const std::span<const std::byte> bytes, UInt64 hash = 0xcbf29ce484222325)
+{
+    for (const auto byte : bytes)
+    {
+        hash = (hash ^ static_cast<UInt64>(byte)) * 0x100000001b3;
+    }
+    return hash;
+}
+
+template<typename>
+struct IsVector : std::false_type
+{
+};
+
+template<typename Element>
+struct IsVector<std::vector<Element>> : std::true_type
+{
+};
+
+template<typename>
+struct IsOptional : std::false_type
+{
+};
+
+template<typename Value>
+struct IsOptional<std::optional<Value>> : std::true_type
+{
+};
+
+// writes tables field by field: structures through their static fields function, strings, vectors and optionals
+// behind their size, anything else trivially copyable as its bytes
+class TableWriter
+{
+public:
+    template<typename... Values>
+    void operator()(const Values&... values)
+    {
+        (write(values), ...);
+    }
+
+    std::vector<std::byte> bytes;
+
+private:
+    template<typename Value>
+    void write(const Value& value)
+    {
+        if constexpr (requires { Value::fields(*this, value); })
+        {
+            Value::fields(*this, value);
+        }
+        else if constexpr (std::is_same_v<Value, std::string>)
+        {
+            write(static_cast<UInt64>(value.size()));
+            append(std::as_bytes(std::span { value }));
+        }
+        else if constexpr (IsVector<Value>::value)
+        {
+            write(static_cast<UInt64>(value.size()));
+            if constexpr (std::is_trivially_copyable_v<typename Value::value_type>)
+            {
+                append(std::as_bytes(std::span { value }));
+            }
+            else
+            {
+                for (const auto& element : value)
+                {
+                    write(element);
+                }
+            }
+        }
+        else if constexpr (IsOptional<Value>::value)
+        {
+            write(value.has_value());
+            if (value)
+            {
+                write(value.value());
+            }
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<Value>);
+            append(std::as_bytes(std::span { &value, 1 }));
+        }
+    }
+
+    void append(const std::span<const std::byte> data)
+    {
+        bytes.insert(bytes.end(), data.begin(), data.end());
+    }
+};
+
+// reads what a TableWriter wrote, with the same fields; throws when the bytes run out
+class TableReader
+{
+public:
+    explicit TableReader(const std::span<const std::byte> bytes)
+        : bytes { bytes }
+    {
+    }
+
+    template<typename... Values>
+    void operator()(Values&... values)
+    {
+        (read(values), ...);
+    }
+
+    bool empty() const
+    {
+        return bytes.empty();
+    }
+
+private:
+    std::span<const std::byte> bytes;
+
+    template<typename Value>
+    void read(Value& value)
+    {
+        if constexpr (requires { Value::fields(*this, value); })
+        {
+            Value::fields(*this, value);
+        }
+        else if constexpr (std::is_same_v<Value, std::string>)
+        {
+            const auto source = take(count(1));
+            value.assign(reinterpret_cast<const char*>(source.data()), source.size());
+        }
+        else if constexpr (IsVector<Value>::value)
+        {
+            using Element = typename Value::value_type;
+            if constexpr (std::is_trivially_copyable_v<Element>)
+            {
+                const auto source = take(count(sizeof(Element)) * sizeof(Element));
+                value.resize(source.size() / sizeof(Element));
+                if (!value.empty())
+                {
+                    std::memcpy(value.data(), source.data(), source.size());
+                }
+            }
+            else
+            {
+                value.resize(count(1));
+                for (auto& element : value)
+                {
+                    read(element);
+                }
+            }
+        }
+        else if constexpr (IsOptional<Value>::value)
+        {
+            bool present;
+            read(present);
+            value.reset();
+            if (present)
+            {
+                read(value.emplace());
+            }
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<Value>);
+            std::memcpy(&value, take(sizeof(Value)).data(), sizeof(Value));
+        }
+    }
+
+    // elements of a string or vector, each taking elementSize bytes at least, which bounds what a damaged count
+    // allocates
+    Size count(const Size elementSize)
+    {
+        UInt64 elements;
+        read(elements);
+        if (elements > bytes.size() / elementSize)
+        {
+            throw std::runtime_error("truncated asset cache table");
+        }
+        return static_cast<Size>(elements);
+    }
+
+    std::span<const std::byte> take(const Size count)
+    {
+        if (count > bytes.size())
+        {
+            throw std::runtime_error("truncated asset cache table");
+        }
+        const auto taken = bytes.first(count);
+        bytes            = bytes.subspan(count);
+        return taken;
+    }
+};
+
+// texture read back from the cache, with the interface of LoadedTexture
+struct CachedTexture
+{
+    std::string                                           name;
+    uint32_t                                              width;
+    uint32_t                                              height;
+    uint32_t                                              mipLevels;
+    uint32_t                                              arrayLayers;
+    std::span<const std::byte>                            pixels;
+    std::vector<std::tuple<uint32_t, uint32_t, uint64_t>> levels;  // mip level, array layer and offset of each image
+
+    const void* data() const
+    {
+        return pixels.data();
+    }
+
+    uint64_t memorySize() const
+    {
+        return pixels.size();
+    }
+
+    const std::vector<std::tuple<uint32_t, uint32_t, uint64_t>>& offsets() const
+    {
+        return levels;
+    }
+};
+
+// the products of an import baked into one file next to the source: vertices, indices, decoded textures and morph
+// deltas as aligned blobs that a later load maps and copies straight into staging buffers, and the tables of the
+// document, so that a warm load parses nothing. The cache is keyed by a hash of the source files and by the version
+// of the importer; the size and write time of each source are recorded too, so that while they hold the sources are
+// not hashed again. Whatever is stored is baked into a new file, which commit puts in place of the old one with the
+// blobs it did not replace: blobs missing from a warm cache are rebuilt and stored again
+class AssetCache
+{
+public:
+    enum class Blob : UInt32
+    {
+        vertices,
+        indices,
+        texture,
+        textureLevels,
+        sources,
+        tables,
+        morphDeltas,
+        morphTargets,
+    };
+
+    AssetCache(const std::filesystem::path& path, const UInt32 importerVersion)
+        : path { path }
+        , header { .importerVersion = importerVersion, .sourceHash = 0 }
+    {
+        if (std::filesystem::exists(path))
+        {
+            open();
+        }
+    }
+
+    AssetCache(const AssetCache&)            = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    // drops what was baked and not committed
+    ~AssetCache()
+    {
+        if (output.is_open())
+        {
+            output.close();
+            std::error_code error;
+            std::filesystem::remove(temporaryPath, error);
+        }
+    }
+
+    // whether the blobs come from the file rather than being baked
+    bool warm() const
+    {
+        return file.has_value();
+    }
+
+    // whether every source still has the size and write time it had when the file was baked
+    bool fresh() const
+    {
+        const auto bytes = array<std::byte>(Blob::sources);
+        if (!bytes)
+        {
+            return false;
+        }
+        std::vector<Source> sources;
+        try
+        {
+            TableReader { bytes.value() }(sources);
+        }
+        catch (const std::runtime_error&)
+        {
+            return false;
+        }
+        return !sources.empty() &&
+               std::all_of(sources.begin(), sources.end(), [](const Source& source) { return source.holds(); });
+    }
+
+    // keeps the file if it was baked from sources with this hash, restamping them, and drops it otherwise
+    void key(const UInt64 sourceHash, const std::vector<std::filesystem::path>& paths)
+    {
+        if (file && header.sourceHash != sourceHash)
+        {
+            file.reset();
+            entries.clear();
+            lookup.clear();
+        }
+        header.sourceHash = sourceHash;
+
+        std::vector<Source> sources;
+        for (const auto& source : paths)
+        {
+            sources.push_back(Source::stamp(source));
+        }
+        TableWriter writer;
+        writer(sources);
+        store(Blob::sources, 0, writer.bytes);
+    }
+
+    template<typename Type>
+    std::optional<std::span<const Type>> array(const Blob blob, const UInt32 index = 0) const
+    {
+        const auto entry = find(blob, index);
+        if (!entry || entry->size % sizeof(Type) != 0)
+        {
+            return std::nullopt;
+        }
+        return std::span { reinterpret_cast<const Type*>(file->bytes().data() + entry->offset),
+                           entry->size / sizeof(Type) };
+    }
+
+    std::optional<CachedTexture> texture(const UInt32 index, const std::string& name) const
+    {
+        const auto entry  = find(Blob::texture, index);
+        const auto levels = array<Level>(Blob::textureLevels, index);
+        if (!entry || !levels)
+        {
+            return std::nullopt;
+        }
+        CachedTexture texture {
+            .name        = name,
+            .width       = entry->extent[0],
+            .height      = entry->extent[1],
+            .mipLevels   = entry->extent[2],
+            .arrayLayers = entry->extent[3],
+            .pixels      = file->bytes().subspan(entry->offset, entry->size),
+            .levels      = {},
+        };
+        for (const auto& [mipLevel, arrayLayer, offset] : levels.value())
+        {
+            texture.levels.emplace_back(mipLevel, arrayLayer, offset);
+        }
+        return texture;
+    }
+
+    // appends a blob to the file being baked, which the first blob starts
+    void store(const Blob blob, const UInt32 index, const std::span<const std::byte> bytes,
+               const std::array<UInt32, 4>& extent = {})
+    {
+        if (!output.is_open() && !bake())
+        {
+            return;
+        }
+        const auto offset = static_cast<UInt64>(output.tellp());
+        const auto padded = (offset + alignment - 1) / alignment * alignment;
+        constexpr std::array<char, alignment> zeros {};
+        output.write(zeros.data(), static_cast<std::streamsize>(padded - offset));
+        output.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        baked.push_back(Entry { blob, index, extent, padded, bytes.size() });
+    }
+
+    template<typename LoadedTexture>
+    void store(const UInt32 index, const LoadedTexture& texture)
+    {
+        std::vector<Level> levels;
+        for (const auto& [mipLevel, arrayLayer, offset] : texture.offsets())
+        {
+            levels.push_back(Level { mipLevel, arrayLayer, offset });
+        }
+        store(Blob::texture, index,
+              std::span { static_cast<const std::byte*>(texture.data()), static_cast<Size>(texture.memorySize()) },
+              { texture.width, texture.height, texture.mipLevels, texture.arrayLayers });
+        store(Blob::textureLevels, index, std::as_bytes(std::span { levels }));
+    }
+
+    // puts the baked file in place, with the blobs of the previous one that were not stored again; a cache that
+    // cannot be written is no error, the next load bakes it again
+    void commit()
+    {
+        if (!output.is_open())
+        {
+            return;
+        }
+        try
+        {
+            std::set<std::pair<Blob, UInt32>> stored;
+            for (const auto& entry : baked)
+            {
+                stored.emplace(entry.blob, entry.index);
+            }
+            for (const auto& entry : entries)
+            {
+                if (!stored.contains({ entry.blob, entry.index }))
+                {
+                    store(entry.blob, entry.index, file->bytes().subspan(entry.offset, entry.size), entry.extent);
+                }
+            }
+
+            header.tableOffset = static_cast<UInt64>(output.tellp());
+            header.entryCount  = baked.size();
+            output.write(reinterpret_cast<const char*>(baked.data()),
+                         static_cast<std::streamsize>(baked.size() * sizeof(Entry)));
+            output.seekp(0);
+            output.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            output.close();
+            if (!output)
+            {
+                throw std::runtime_error("failed to write asset cache '" + path.string() + "'");
+            }
+            // concurrent loads bake files of their own, the last one renamed wins
+            std::filesystem::rename(temporaryPath, path);
+        }
+        catch (const std::exception&)
+        {
+            output.close();
+            std::error_code error;
+            std::filesystem::remove(temporaryPath, error);
+        }
+    }
+
+private:
+    static constexpr std::array<char, 8> magic { 'S', 'U', 'R', 'G', 'E', 'A', 'C', '\0' };
+    static constexpr UInt32              layoutVersion { 2 };
+    static constexpr UInt64              alignment { 64 };
+
+    struct Header
+    {
+        std::array<char, 8> magic { AssetCache::magic };
+        UInt32              layoutVersion { AssetCache::layoutVersion };
+        UInt32              importerVersion;
+        UInt64              sourceHash;
+        UInt64              tableOffset { 0 };
+        UInt64              entryCount { 0 };
+    };
+
+    struct Entry
+    {
+        Blob                  blob;
+        UInt32                index;
+        std::array<UInt32, 4> extent;  // width, height, mip levels and array layers of a texture
+        UInt64                offset;
+        UInt64                size;
+    };
+
+    struct Level
+    {
+        UInt32 mipLevel;
+        UInt32 arrayLayer;
+        UInt64 offset;
+    };
+
+    // a source file as it was when hashed
+    struct Source
+    {
+        std::string path;
+        UInt64      size;
+        Int64       time;
+
+        template<typename Archive, typename Self>
+        static void fields(Archive& archive, Self& self)
+        {
+            archive(self.path, self.size, self.time);
+        }
+
+        static Source stamp(const std::filesystem::path& path)
+        {
+            return Source { path.string(), static_cast<UInt64>(std::filesystem::file_size(path)),
+                            static_cast<Int64>(std::filesystem::last_write_time(path).time_since_epoch().count()) };
+        }
+
+        bool holds() const
+        {
+            std::error_code error;
+            const auto      size = std::filesystem::file_size(path, error);
+            const auto      time = std::filesystem::last_write_time(path, error);
+            return !error && size == this->size && static_cast<Int64>(time.time_since_epoch().count()) == this->time;
+        }
+    };
+
+    std::filesystem::path                   path;
+    std::filesystem::path                   temporaryPath;  // of the file being baked
+    Header                                  header;
+    std::optional<MappedFile>               file;
+    std::map<std::pair<Blob, UInt32>, Size> lookup;  // entry of each blob
+    std::vector<Entry>                      entries;
+    std::vector<Entry>                      baked;
+    std::ofstream                           output;
+
+    std::optional<Entry> find(const Blob blob, const UInt32 index) const
+    {
+        const auto found = lookup.find({ blob, index });
+        if (found == lookup.end())
+        {
+            return std::nullopt;
+        }
+        return entries[found->second];
+    }
+
+    // keeps the file if it is complete and was baked by this importer
+    void open()
+    {
+        MappedFile mapped { path };
+        const auto bytes = mapped.bytes();
+
+        Header stored;
+        if (bytes.size() < sizeof(Header))
+        {
+            return;
+        }
+        std::memcpy(&stored, bytes.data(), sizeof(Header));
+        if (stored.magic != magic || stored.layoutVersion != header.layoutVersion ||
+            stored.importerVersion != header.importerVersion || stored.tableOffset > bytes.size() ||
+            stored.entryCount > (bytes.size() - stored.tableOffset) / sizeof(Entry))
+        {
+            return;
+        }
+
+        entries.resize(stored.entryCount);
+        if (!entries.empty())
+        {
+            std::memcpy(entries.data(), bytes.data() + stored.tableOffset, stored.entryCount * sizeof(Entry));
+        }
+        for (Size i = 0; i < entries.size(); ++i)
+        {
+            const auto& entry = entries[i];
+            if (entry.offset > stored.tableOffset || entry.size > stored.tableOffset - entry.offset)
+            {
+                entries.clear();
+                lookup.clear();
+                return;
+            }
+            lookup.emplace(std::pair { entry.blob, entry.index }, i);
+        }
+        header.sourceHash = stored.sourceHash;
+        file.emplace(std::move(mapped));
+    }
+
+    // under a name of its own, so that loads of the same asset do not write into each other's file; the header is
+    // written last, so that an interrupted bake leaves no valid file
+    bool bake()
+    {
+        temporaryPath = path.string() + "." + std::to_string(std::random_device {}()) + ".part";
+        output.open(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (output.is_open())
+        {
+            const Header placeholder { .magic = {}, .importerVersion = 0, .sourceHash = 0 };
+            output.write(reinterpret_cast<const char*>(&placeholder), sizeof(Header));
+        }
+        return output.is_open();
+    }
+};
+
+}  // namespace surge::asset
@@ -0,0 +1,254 @@
+#pragma once
+
+#include "surge/Buffer.hpp"
+#include "surge/Descriptor.hpp"
+#include "surge/asset/Asset.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace surge::asset
+{
+
+// many copies of one skinned asset, each playing a clip of its own at its own phase; the palettes of all instances
+// are packed into one ssbo, instance i owning the joints [i * paletteStride, (i + 1) * paletteStride), so that every
+// primitive is drawn once for the whole crowd. Only the skinned nodes are drawn, morph targets keep their rest weights
+class Crowd
+{
+public:
+    using SSBOBufferInfo = ShaderStorageBufferObject::SSBOBufferInfo;
+    using SSBODescr      = Description<VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT, Buffer>;
+
+    struct Instance
+    {
+        math::Vector<3> translation;
+        uint32_t        animation;   // index of the clip in the asset
+        float           timeOffset;  // seconds ahead of the crowd clock
+    };
+
+    // with a sample rate, clip times snap to its frames so that instances in the same frame of a clip share one sampled
+    // palette; without, every instance is sampled
+    Crowd(const Asset& asset, const std::vector<Instance>& instances, const std::optional<float> sampleRate = {})
+        : asset { asset }
+        , instances { instances }
+        , sampleRate { sampleRate }
+        , paletteStride { asset.jointCount() }
+        , palettes { checkedSize(asset, instances) * Asset::jointBytes(asset.skinningMethod), SSBOBufferInfo {} }
+        , placements { instances.size() * sizeof(math::Vector<4>), SSBOBufferInfo {} }
+        , descriptor { 1, SSBODescr { palettes }, SSBODescr { placements } }
+        , state {}
+        , parents { createParents(asset) }
+        , joints { createJoints(asset) }
+        , sampling(instances.size())
+    {
+        auto* placement = static_cast<math::Vector<4>*>(placements.mapped);
+        for (const auto& instance : instances)
+        {
+            const auto& translation = instance.translation;
+            *placement++            = { translation[0], translation[1], translation[2], 1 };
+        }
+    }
+
+    const Asset&                asset;
+    const std::vector<Instance> instances;
+    const std::optional<float>  sampleRate;
+    const uint32_t              paletteStride;  // joints per instance
+    Buffer                      palettes;       // matrices or dual quaternions, as the asset's joint palettes
+    Buffer                      placements;     // translation per instance
+    Descriptor                  descriptor;
+
+    struct State
+    {
+        bool     active { true };
+        double   time { 0 };
+        uint32_t sampledPalettes { 0 };  // computed by the latest update, the others were copied
+        Size     uploadedBytes { 0 };
+    };
+    mutable State state;
+
+    void update(const double elapsedTime)
+    {
+        state.time += elapsedTime;
+        state.sampledPalettes = 0;
+        state.uploadedBytes   = 0;
+        sampled.clear();
+
+        const auto jointBytes   = Asset::jointBytes(asset.skinningMethod);
+        const auto paletteBytes = paletteStride * jointBytes;
+        auto*      destination  = static_cast<std::byte*>(palettes.mapped);
+        for (std::size_t i = 0; i < instances.size(); ++i, destination += paletteBytes)
+        {
+            const auto& instance  = instances[i];
+            const auto& animation = asset.animations[instance.animation];
+            auto        time      = animation.end > 0 ?
+                                        static_cast<float>(std::fmod(state.time + instance.timeOffset, animation.end)) :
+                                        0.0f;
+            // shared palettes are sampled to host memory and copied from there: the mapped palettes are write
+            // combined, reading them back is slow
+            auto* palette = destination;
+            if (sampleRate)
+            {
+                const auto frame = static_cast<uint32_t>(std::floor(time * sampleRate.value()));
+                time             = frame / sampleRate.value();
+
+                const auto [first, inserted] =
+                    sampled.try_emplace({ instance.animation, frame }, sampled.size() * paletteBytes);
+                if (!inserted)
+                {
+                    memcpy(destination, scratch.data() + first->second, paletteBytes);
+                    continue;
+                }
+                scratch.resize(std::max(scratch.size(), first->second + paletteBytes));
+                palette = scratch.data() + first->second;
+            }
+
+            pose = asset.restPose;
+            animation.sampleAt(time, sampling[i], pose);
+            computeGlobalMatrices();
+            if (asset.skinningMethod == SkinningMethod::dualQuaternion)
+            {
+                auto* dualQuaternion = reinterpret_cast<math::DualQuaternion<>*>(palette);
+                for (const auto& [node, inverseBindMatrix] : joints)
+                {
+                    *dualQuaternion++ =
+                        math::toDualQuaternion(math::fullMatrix(globalMatrices[node] * *inverseBindMatrix));
+                }
+            }
+            else
+            {
+                auto* matrix = reinterpret_cast<math::Matrix<4, 4>*>(palette);
+                for (const auto& [node, inverseBindMatrix] : joints)
+                {
+                    *matrix++ = math::fullMatrix(globalMatrices[node] * *inverseBindMatrix);
+                }
+            }
+            if (palette != destination)
+            {
+                memcpy(destination, palette, paletteBytes);
+            }
+            ++state.sampledPalettes;
+        }
+        state.uploadedBytes = instances.size() * paletteBytes;
+    }
+
+    uint32_t instanceCount() const
+    {
+        return static_cast<uint32_t>(instances.size());
+    }
+
+private:
+    // the joint of a palette entry, as an index of the asset's nodes lut
+    struct Joint
+    {
+        std::size_t           node;
+        const math::Affine<>* inverseBindMatrix;
+    };
+
+    // lut index of the parent of every node, parents listed before their children
+    std::vector<std::pair<std::size_t, std::optional<std::size_t>>> parents;
+    // palette layout shared by all instances; the node matrix is left out of the joint matrices and of the draws
+    std::vector<Joint> joints;
+
+    // playback of each instance, so that sampling moves neither the clip of the asset nor the other instances
+    std::vector<Animation::State> sampling;
+
+    // scratch
+    Pose                                           pose { asset.restPose };
+    std::vector<math::Affine<>>                    globalMatrices;
+    std::vector<std::byte>                         scratch;  // the palettes sampled by the latest update
+    std::map<std::pair<uint32_t, uint32_t>, Size> sampled;  // offset in scratch of the palette of a clip and frame
+
+    void computeGlobalMatrices()
+    {
+        globalMatrices.resize(pose.size());
+        for (const auto& [node, parent] : parents)
+        {
+            const auto localMatrix = math::affine(math::Translation { pose.translations[node] },
+                                                  math::Rotation { pose.rotations[node] },
+                                                  math::Scaling { pose.scales[node] });
+            globalMatrices[node] = parent ? globalMatrices[parent.value()] * localMatrix : localMatrix;
+        }
+    }
+
+    static std::size_t checkedSize(const Asset& asset, const std::vector<Instance>& instances)
+    {
+        if (asset.jointPalettes.empty())
+        {
+            throw std::runtime_error("crowd of " + asset.name + ": the asset has no skinned node");
+        }
+        if (instances.empty())
+        {
+            throw std::runtime_error("crowd of " + asset.name + ": no instances");
+        }
+        for (const auto& instance : instances)
+        {
+            if (instance.animation >= asset.animations.size())
+            {
+                throw std::runtime_error("crowd of " + asset.name + ": no animation " +
+                                         std::to_string(instance.animation));
+            }
+        }
+        return instances.size() * asset.jointCount();
+    }
+
+    static std::unordered_map<const Node*, std::size_t> createLutIndices(const Asset& asset)
+    {
+        std::unordered_map<const Node*, std::size_t> indices;
+        const auto&                                  nodesLut = asset.mainScene().nodesLut;
+        for (std::size_t i = 0; i < nodesLut.size(); ++i)
+        {
+            if (nodesLut[i])
+            {
+                indices.emplace(nodesLut[i], i);
+            }
+        }
+        return indices;
+    }
+
+    static std::vector<std::pair<std::size_t, std::optional<std::size_t>>> createParents(const Asset& asset)
+    {
+        const auto indices = createLutIndices(asset);
+
+        std::vector<std::pair<std::size_t, std::optional<std::size_t>>> parents;
+        const std::function<void(const Node&, std::optional<std::size_t>)> collect =
+            [&](const Node& node, const std::optional<std::size_t> parent)
+        {
+            const auto index = indices.at(&node);
+            parents.emplace_back(index, parent);
+            for (const auto& child : node.children)
+            {
+                collect(child, index);
+            }
+        };
+        for (const auto& node : asset.mainScene().nodes)
+        {
+            collect(node, std::nullopt);
+        }
+        return parents;
+    }
+
+    static std::vector<Joint> createJoints(const Asset& asset)
+    {
+        const auto indices = createLutIndices(asset);
+
+        std::vector<Joint> joints;
+        joints.reserve(asset.jointCount());
+        for (const auto& palette : asset.jointPalettes)
+        {
+            for (const auto& [node, inverseBindMatrix] : palette.skin.joints)
+            {
+                joints.push_back(Joint { indices.at(&node), &inverseBindMatrix });
+            }
+        }
+        return joints;
+    }
+};
+
+}  // namespace surge::asset
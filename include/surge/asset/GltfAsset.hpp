@@ -1,10 +1,18 @@
 #pragma once
 
+#include "surge/WorkQueue.hpp"
+#include "surge/asset/AssetCache.hpp"
+#include "surge/asset/GltfTables.hpp"
+#include "surge/asset/MappedFile.hpp"
 #include "surge/asset/Node.hpp"
 #include "surge/asset/Scene.hpp"
 #include "surge/asset/Skin.hpp"
 #include "surge/geometry/Shape.hpp"
 #include "surge/geometry/Vertex.hpp"
+#include "surge/geometry/VertexLayout.hpp"
+#include "surge/geometry/indices.hpp"
+#include "surge/geometry/optimize.hpp"
+#include "surge/geometry/quantize.hpp"
 #include "surge/math/Vector.hpp"
 
 #include "fastgltf/core.hpp"
@@ -13,7 +21,17 @@
 #include "fastgltf/util.hpp"
 #include "fastgltf/glm_element_traits.hpp"
 
+#include <array>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 namespace fastgltf
 {
@@ -48,36 +66,173 @@ struct ElementTraits<surge::math::Matrix<4, 4>>
 namespace surge::asset
 {
 
+// the value is the specialization constant of the skinning shaders
+enum class SkinningMethod : uint32_t
+{
+    linear,          // one matrix per joint
+    dualQuaternion,  // one dual quaternion per joint, rigid joints only
+};
+
+struct AnimationImportOptions
+{
+    std::optional<float> tolerance { 1.e-4f };  // compress tracks, keeping this error bound
+    std::optional<float> bakeRate {};           // pre-sample clips at this many frames per second
+    float                bakeErrorBudget { 1.e-3f };
+    SkinningMethod       skinning { SkinningMethod::linear };
+};
+
+struct LoadStatistics
+{
+    double seconds { 0 };            // parsing, the uploads are not included
+    Size   mappedBytes { 0 };        // files read in place
+    Size   copiedBytes { 0 };        // decoded data uris, or a glb chunk that could not be read in place
+    Size   peakResidentBytes { 0 };  // of the whole process, once the document is read
+    bool   cached { false };         // whether a baked cache matched the sources
+    double hashSeconds { 0 };        // checking the sources, and hashing them if they changed, to key the cache
+    double textureSeconds { 0 };     // decoding or reading back, and uploading the textures
+    double modelSeconds { 0 };       // converting or reading back, and uploading the vertices and indices
+
+    geometry::CacheStatistics vertexCacheBefore {};  // of the source order, unknown when cached
+    geometry::CacheStatistics vertexCacheAfter {};   // of the optimized order
+};
+
+// adds the seconds it lived to a statistic; outlives the return value of the function it times
+class LoadTimer
+{
+public:
+    explicit LoadTimer(double& seconds)
+        : seconds { seconds }
+        , start { std::chrono::steady_clock::now() }
+    {
+    }
+
+    ~LoadTimer()
+    {
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    double&                               seconds;
+    std::chrono::steady_clock::time_point start;
+};
+
 class GltfAsset
 {
 public:
     using TextureDescr = TextureDescription<VK_SHADER_STAGE_FRAGMENT_BIT>;
     using Index        = geometry::Index;
-    using Vertex       = geometry::Vertex<
-              geometry::AttributeSlot<geometry::Attribute::position, math::Vector<3>, 3, geometry::Format::sfloat>,
-              geometry::AttributeSlot<geometry::Attribute::color, math::Vector<4>, 4, geometry::Format::sfloat>,
-              geometry::AttributeSlot<geometry::Attribute::normal, math::Vector<3>, 3, geometry::Format::sfloat>,
-              geometry::AttributeSlot<geometry::Attribute::texCoord, math::Vector<2>, 2, geometry::Format::sfloat>,
-              geometry::AttributeSlot<geometry::Attribute::jointIndex, math::Vector<4>, 4, geometry::Format::sfloat>,
-              geometry::AttributeSlot<geometry::Attribute::jointWeight, math::Vector<4>, 4, geometry::Format::sfloat>>;
-
-    GltfAsset(const std::string& name, const std::filesystem::path& path)
+    // normals as octahedral snorm16, texture coordinates as halves, so that repeating ones keep working, colours as
+    // unorm8, joints as uint16 and weights as unorm16. The colour slot only keeps the shader locations, it is never
+    // uploaded, and the layout halves the joints to uint8 unless a skin has more than 256 of them: 32 bytes uploaded
+    // for a skinned vertex. Positions are a stream of their own, which the depth pass reads alone
+    using Vertex = geometry::Vertex<
+        geometry::AttributeSlot<geometry::Attribute::position, math::Vector<3>, 3, geometry::Format::sfloat, 0>,
+        geometry::AttributeSlot<geometry::Attribute::color, std::array<UInt8, 4>, 4, geometry::Format::unorm, 1>,
+        geometry::AttributeSlot<geometry::Attribute::normal, std::array<Int16, 2>, 2, geometry::Format::snorm, 1>,
+        geometry::AttributeSlot<geometry::Attribute::texCoord, std::array<UInt16, 2>, 2, geometry::Format::sfloat, 1>,
+        geometry::AttributeSlot<geometry::Attribute::jointIndex, std::array<UInt16, 4>, 4, geometry::Format::uint, 1>,
+        geometry::AttributeSlot<geometry::Attribute::jointWeight, std::array<UInt16, 4>, 4, geometry::Format::unorm,
+                                1>>;
+
+    GltfAsset(const std::string&            name,
+              const std::filesystem::path&   path,
+              const AnimationImportOptions& animationOptions = {})
         : name { name }
         , path { path }
-        , asset { createAsset(path) }
+        , animationOptions { animationOptions }
+        , files {}
+        , allocations {}
+        , sources {}
+        , loadStatistics {}
+        , cache { path.string() + ".cache", importerVersion }
+        , parsed {}
+        , tables { createTables() }
+        , layout { createLayout() }
     {
+        loadStatistics.cached            = cache.warm();
+        loadStatistics.peakResidentBytes = peakResidentBytes();
     }
 
-    std::string           name;
-    std::filesystem::path path;
-    fastgltf::Asset       asset;
+    // bumped whenever the baked vertices, indices, textures or tables change
+    static constexpr uint32_t importerVersion { 7 };
+
+    std::string             name;
+    std::filesystem::path   path;
+    AnimationImportOptions  animationOptions;
+    std::vector<MappedFile> files;  // the gltf or glb and its external buffers, which the accessors read in place
+    std::vector<std::unique_ptr<std::byte[]>> allocations;  // the buffers of data uris, which the accessors read too
+    std::vector<std::filesystem::path>        sources;      // the files, then the images the document refers to
+    LoadStatistics                            loadStatistics;
+    AssetCache                                cache;
+    std::optional<fastgltf::Asset>            parsed;  // only once the cache lacks something built from the document
+    GltfTables                                tables;
+    geometry::VertexLayout                    layout;  // of the vertices uploaded
 
     std::string shader() const
     {
-        return asset.skins.empty() ? "gltf_static" : "gltf_animated";
+        return tables.skins.empty() ? "gltf_static" : "gltf_animated";
+    }
+
+    // parses the document the first time it is needed
+    const fastgltf::Asset& source()
+    {
+        if (!parsed)
+        {
+            parsed.emplace(createAsset(path, files, allocations, sources, loadStatistics));
+        }
+        return parsed.value();
     }
 
-    Sampler createSampler(const uint32_t samplerIndex) const
+    // read back from the cache while the sources keep their size and write time; otherwise the document is parsed and
+    // the sources hashed, which may still find the cache valid
+    GltfTables createTables()
+    {
+        const auto fresh = [&]
+        {
+            const LoadTimer timer { loadStatistics.hashSeconds };
+            return cache.fresh();
+        }();
+        if (fresh)
+        {
+            if (auto cached = cachedTables())
+            {
+                return std::move(cached.value());
+            }
+        }
+
+        const auto& asset = source();
+        {
+            const LoadTimer timer { loadStatistics.hashSeconds };
+            cache.key(hashSources(), sources);
+        }
+        if (auto cached = cachedTables())
+        {
+            return std::move(cached.value());
+        }
+
+        auto extracted = extractTables(asset);
+        cache.store(AssetCache::Blob::tables, 0, extracted.write());
+        return extracted;
+    }
+
+    std::optional<GltfTables> cachedTables() const
+    {
+        const auto bytes = cache.array<std::byte>(AssetCache::Blob::tables);
+        if (!bytes)
+        {
+            return std::nullopt;
+        }
+        try
+        {
+            return GltfTables::read(bytes.value());
+        }
+        catch (const std::runtime_error&)
+        {
+            return std::nullopt;
+        }
+    }
+
+    static Sampler createSampler(const fastgltf::Asset& asset, const uint32_t samplerIndex)
     {
         constexpr auto extractFilter = [](const fastgltf::Filter filter)
         {
@@ -141,60 +296,110 @@ public:
         };
     }
 
-    std::vector<Texture> createTextures(const Command& command, const Defaults& defaults) const
+    // images are read back from the cache, or decoded on worker threads; each image waits in the slot of its glTF
+    // texture until the ones before it are uploaded, so that the textures keep the order of the glTF textures
+    std::vector<Texture> createTextures(const Command& command, const Defaults& defaults)
     {
-        std::vector<Texture> textures;
-        textures.reserve(asset.images.size());
-        uint32_t textureId = 0;
-        for (const fastgltf::Texture& texture : asset.textures)
-        {
-            assert(texture.imageIndex && texture.imageIndex.value() < asset.images.size());
+        using Decoded = std::unique_ptr<LoadedTexture>;
 
-            const auto& image = asset.images.at(texture.imageIndex.value());
-            const auto  name  = baptize<This::texture>(texture.name, textureId++);
+        const LoadTimer timer { loadStatistics.textureSeconds };
 
-            const fastgltf::visitor visitor {
-                [](const auto&) -> LoadedTexture { throw std::runtime_error("unsupported visitor"); },
-                [&](const fastgltf::sources::URI& uri) -> LoadedTexture
-                { return LoadedTexture { name, std::filesystem::path { path.parent_path() / uri.uri.path() } }; },
-                [&](const fastgltf::sources::Vector& vector) -> LoadedTexture
-                {
-                    return LoadedTexture { name, reinterpret_cast<const uint8_t*>(vector.bytes.data()),
-                                           vector.bytes.size() };
-                },
-                [&](const fastgltf::sources::Array& array) -> LoadedTexture
-                {
-                    return LoadedTexture { name, reinterpret_cast<const uint8_t*>(array.bytes.data()),
-                                           array.bytes.size() };
-                },
-                [&](const fastgltf::sources::BufferView& view) -> LoadedTexture
+        std::vector<std::optional<CachedTexture>> cached(tables.textures.size());
+        std::vector<Decoded>                      decoded(tables.textures.size());
+        std::vector<WorkQueue<Decoded>::Job>      jobs;
+        std::vector<uint32_t>                     decodedTextures;  // glTF texture of each job
+        for (uint32_t index = 0; index < tables.textures.size(); ++index)
+        {
+            const auto& texture = tables.textures[index];
+            cached[index]       = cache.texture(index, texture.name);
+            if (cached[index])
+            {
+                continue;
+            }
+
+            const auto& asset = source();
+            assert(texture.image < asset.images.size());
+            const auto& image = asset.images.at(texture.image);
+            decodedTextures.push_back(index);
+            jobs.emplace_back(
+                [this, &asset, &image, &name = texture.name]
                 {
-                    const auto&     bufferView = asset.bufferViews.at(view.bufferViewIndex);
-                    const auto&     buffer     = asset.buffers.at(bufferView.bufferIndex);
-                    const fastgltf::visitor visitor    = {
-                        [](const auto&) -> LoadedTexture { throw std::runtime_error("unsupported visitor"); },
-                        [&](const fastgltf::sources::Vector& vector) -> LoadedTexture
+                    const fastgltf::visitor visitor {
+                        [](const auto&) -> Decoded { throw std::runtime_error("unsupported visitor"); },
+                        [&](const fastgltf::sources::URI& uri) -> Decoded
                         {
-                            return LoadedTexture { name,
-                                                   reinterpret_cast<const uint8_t*>(vector.bytes.data()) +
-                                                       bufferView.byteOffset,
-                                                   bufferView.byteLength };
+                            return std::make_unique<LoadedTexture>(
+                                name, std::filesystem::path { path.parent_path() / uri.uri.path() });
                         },
-                        [&](const fastgltf::sources::Array& array) -> LoadedTexture
+                        [&](const fastgltf::sources::Vector& vector) -> Decoded
                         {
-                            return LoadedTexture { name,
-                                                   reinterpret_cast<const uint8_t*>(array.bytes.data()) +
-                                                       bufferView.byteOffset,
-                                                   bufferView.byteLength };
-                        }
+                            return std::make_unique<LoadedTexture>(
+                                name, reinterpret_cast<const uint8_t*>(vector.bytes.data()), vector.bytes.size());
+                        },
+                        [&](const fastgltf::sources::Array& array) -> Decoded
+                        {
+                            return std::make_unique<LoadedTexture>(
+                                name, reinterpret_cast<const uint8_t*>(array.bytes.data()), array.bytes.size());
+                        },
+                        [&](const fastgltf::sources::ByteView& view) -> Decoded
+                        {
+                            return std::make_unique<LoadedTexture>(
+                                name, reinterpret_cast<const uint8_t*>(view.bytes.data()), view.bytes.size());
+                        },
+                        [&](const fastgltf::sources::BufferView& view) -> Decoded
+                        {
+                            const auto&             bufferView = asset.bufferViews.at(view.bufferViewIndex);
+                            const auto&             buffer     = asset.buffers.at(bufferView.bufferIndex);
+                            const fastgltf::visitor visitor    = {
+                                [](const auto&) -> Decoded { throw std::runtime_error("unsupported visitor"); },
+                                [&](const fastgltf::sources::Vector& vector) -> Decoded
+                                {
+                                    return std::make_unique<LoadedTexture>(
+                                        name,
+                                        reinterpret_cast<const uint8_t*>(vector.bytes.data()) + bufferView.byteOffset,
+                                        bufferView.byteLength);
+                                },
+                                [&](const fastgltf::sources::Array& array) -> Decoded
+                                {
+                                    return std::make_unique<LoadedTexture>(
+                                        name,
+                                        reinterpret_cast<const uint8_t*>(array.bytes.data()) + bufferView.byteOffset,
+                                        bufferView.byteLength);
+                                },
+                                [&](const fastgltf::sources::ByteView& bytes) -> Decoded
+                                {
+                                    return std::make_unique<LoadedTexture>(
+                                        name,
+                                        reinterpret_cast<const uint8_t*>(bytes.bytes.data()) + bufferView.byteOffset,
+                                        bufferView.byteLength);
+                                }
+                            };
+                            return std::visit(visitor, buffer.data);
+                        },
                     };
-                    return std::visit(visitor, buffer.data);
-                },
-            };
-
-            const auto sampler = texture.samplerIndex ? createSampler(texture.samplerIndex.value()) : defaults.sampler;
+                    return std::visit(visitor, image.data);
+                });
+        }
 
-            textures.emplace_back(command, std::visit(visitor, image.data), sampler, SceneTextureInfo {});
+        std::vector<Texture> textures;
+        textures.reserve(tables.textures.size());
+        WorkQueue<Decoded> queue { std::move(jobs) };
+        for (uint32_t index = 0; index < tables.textures.size(); ++index)
+        {
+            const auto sampler = tables.textures[index].sampler.value_or(defaults.sampler);
+            if (cached[index])
+            {
+                textures.emplace_back(command, cached[index].value(), sampler, SceneTextureInfo {});
+                continue;
+            }
+            while (!decoded[index])
+            {
+                auto [job, loadedTexture]     = queue.take();
+                decoded[decodedTextures[job]] = std::move(loadedTexture);
+            }
+            textures.emplace_back(command, *decoded[index], sampler, SceneTextureInfo {});
+            cache.store(index, *decoded[index]);
+            decoded[index].reset();
         }
         return textures;
     }
@@ -202,10 +407,10 @@ public:
     VkDescriptorPool createDescriptorPool() const
     {
         return Descriptor::createDescriptorPool(
-            asset.materials.size() + asset.meshes.size() + asset.skins.size(),
-            std::pair { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, static_cast<uint32_t>(5 * asset.materials.size()) },
-            std::pair { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, static_cast<uint32_t>(asset.meshes.size()) },
-            std::pair { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<uint32_t>(asset.skins.size()) });
+            tables.materials.size() + tables.meshes.size() + tables.skins.size(),
+            std::pair { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, static_cast<uint32_t>(5 * tables.materials.size()) },
+            std::pair { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, static_cast<uint32_t>(tables.meshes.size()) },
+            std::pair { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<uint32_t>(tables.skins.size()) });
     }
 
     VkDescriptorSetLayout createMaterialDescriptorSetLayout() const
@@ -218,39 +423,18 @@ public:
                                                      >(1);
     }
 
-    static Material::TextureData extractTexture(const std::vector<Texture>& textures, const Defaults& defaults,
-                                                const auto& textureInfo)
-    {
-        if (textureInfo)
-        {
-            const auto textureIndex  = textureInfo.value().textureIndex;
-            const auto texCoordIndex = textureInfo.value().texCoordIndex;
-            assert(0 <= textureIndex && textureIndex < textures.size());
-            return Material::TextureData {
-                .texture  = &textures.at(textureIndex),
-                .texCoord = static_cast<uint8_t>(texCoordIndex),
-            };
-        }
-        return Material::TextureData {
-            .texture  = &defaults.texture,  // default
-            .texCoord = 0,
-        };
-    }
-
     std::vector<Material> createMaterials(const Defaults& defaults, const VkDescriptorPool descriptorPool,
                                           const VkDescriptorSetLayout materialDescriptorSetLayout,
                                           const std::vector<Texture>& textures) const
     {
-        const auto extractTexture = [&textures, &defaults](const auto& textureInfo)
+        const auto extractTexture = [&textures, &defaults](const GltfTables::TextureSlot& slot)
         {
-            if (textureInfo)
+            if (slot.texture)
             {
-                const auto textureIndex  = textureInfo.value().textureIndex;
-                const auto texCoordIndex = textureInfo.value().texCoordIndex;
-                assert(0 <= textureIndex && textureIndex < textures.size());
+                assert(slot.texture.value() < textures.size());
                 return Material::TextureData {
-                    .texture  = &textures.at(textureIndex),
-                    .texCoord = static_cast<uint8_t>(texCoordIndex),
+                    .texture  = &textures.at(slot.texture.value()),
+                    .texCoord = slot.texCoord,
                 };
             }
             return Material::TextureData {
@@ -259,62 +443,34 @@ public:
             };
         };
 
-        constexpr auto extractAlphaMode = [](const fastgltf::AlphaMode alphaMode)
-        {
-            switch (alphaMode)
-            {
-            case fastgltf::AlphaMode::Blend:
-                return Material::AlphaMode::blend;
-            case fastgltf::AlphaMode::Mask:
-                return Material::AlphaMode::mask;
-            case fastgltf::AlphaMode::Opaque:
-                return Material::AlphaMode::opaque;
-            }
-            throw;
-        };
-
         std::vector<Material> materials;
-        materials.reserve(asset.materials.size());
-        uint32_t materialId = 0;
-        for (const fastgltf::Material& material : asset.materials)
+        materials.reserve(tables.materials.size());
+        for (const auto& material : tables.materials)
         {
-            const auto            baseColorTexture = extractTexture(material.pbrData.baseColorTexture);
-            const math::Vector<4> baseColorFactor { material.pbrData.baseColorFactor[0],
-                                                    material.pbrData.baseColorFactor[1],
-                                                    material.pbrData.baseColorFactor[2],
-                                                    material.pbrData.baseColorFactor[3] };
-
-            const auto metallicRoughnessTexture = extractTexture(material.pbrData.metallicRoughnessTexture);
-
-            const auto            emissiveTexture = extractTexture(material.emissiveTexture);
-            const math::Vector<4> emissiveFactor { material.emissiveFactor[0], material.emissiveFactor[1],
-                                                   material.emissiveFactor[2], 1 };
-
-            const auto normalTexture = extractTexture(material.normalTexture);
-            const auto normalScale   = material.normalTexture ? material.normalTexture.value().scale : 1.0f;
-
-            const auto occlusionTexture = extractTexture(material.occlusionTexture);
-            const auto occlusionStrength =
-                material.occlusionTexture ? material.occlusionTexture.value().strength : 1.0f;
+            const auto baseColorTexture         = extractTexture(material.baseColorTexture);
+            const auto metallicRoughnessTexture = extractTexture(material.metallicRoughnessTexture);
+            const auto emissiveTexture          = extractTexture(material.emissiveTexture);
+            const auto normalTexture            = extractTexture(material.normalTexture);
+            const auto occlusionTexture         = extractTexture(material.occlusionTexture);
 
             materials.emplace_back(Material {
-                .name                     = baptize<This::material>(material.name, materialId++),
+                .name                     = material.name,
                 .doubleSided              = material.doubleSided,
                 .unlit                    = material.unlit,
-                .alphaMode                = extractAlphaMode(material.alphaMode),
+                .alphaMode                = material.alphaMode,
                 .alphaCutoff              = material.alphaCutoff,
                 .baseColorTexture         = baseColorTexture,
-                .baseColorFactor          = baseColorFactor,
+                .baseColorFactor          = material.baseColorFactor,
                 .metallicRoughnessTexture = metallicRoughnessTexture,
-                .metallicFactor           = material.pbrData.metallicFactor,
-                .roughnessFactor          = material.pbrData.roughnessFactor,
+                .metallicFactor           = material.metallicFactor,
+                .roughnessFactor          = material.roughnessFactor,
                 .emissiveTexture          = emissiveTexture,
-                .emissiveFactor           = emissiveFactor,
+                .emissiveFactor           = material.emissiveFactor,
                 .emissiveStrength         = material.emissiveStrength,
                 .normalTexture            = normalTexture,
-                .normalScale              = normalScale,
+                .normalScale              = material.normalScale,
                 .occlusionTexture         = occlusionTexture,
-                .occlusionStrength        = occlusionStrength,
+                .occlusionStrength        = material.occlusionStrength,
                 .descriptorSet            = Descriptor::createDescriptorSet(
                     materialDescriptorSetLayout, descriptorPool,  //
                     TextureDescr { *baseColorTexture.texture }, TextureDescr { *metallicRoughnessTexture.texture },
@@ -329,65 +485,181 @@ public:
     std::vector<Mesh> createMeshes(const Defaults& defaults, const std::vector<Material>& materials) const
     {
         uint32_t partialIndexCount { 0 };
+        uint32_t partialVertexCount { 0 };
 
         std::vector<Mesh> meshes;
-        meshes.reserve(asset.meshes.size());
-        uint32_t meshId = 0;
-        for (const fastgltf::Mesh& fastgltfMesh : asset.meshes)
+        meshes.reserve(tables.meshes.size());
+        for (const auto& tableMesh : tables.meshes)
         {
-            auto& mesh = meshes.emplace_back(baptize<This::mesh>(fastgltfMesh.name, meshId++));
-            mesh.primitives.reserve(fastgltfMesh.primitives.size());
-            for (const fastgltf::Primitive& primitive : fastgltfMesh.primitives)
+            auto& mesh = meshes.emplace_back(tableMesh.name);
+            mesh.primitives.reserve(tableMesh.primitives.size());
+            for (const auto& primitive : tableMesh.primitives)
             {
-                const fastgltf::Accessor& positionAccessor =
-                    asset.accessors.at(primitive.findAttribute("POSITION")->accessorIndex);
-
-                const auto indexCount  = asset.accessors.at(primitive.indicesAccessor.value()).count;
-                const auto vertexCount = positionAccessor.count;
-
-                // constexpr auto cast = [](auto t) { return static_cast<Float32>(t); };
-
-                constexpr auto  minValue = std::numeric_limits<math::Vector<3>::value_type>::min();
-                constexpr auto  maxValue = std::numeric_limits<math::Vector<3>::value_type>::min();
-                math::Vector<3> min { maxValue, maxValue, maxValue };
-                math::Vector<3> max { minValue, minValue, minValue };
-                using PositionAttribute =
-                    typename Vertex::Attribute<Vertex::attributeIndex<geometry::Attribute::position>()>::Value;
-                fastgltf::iterateAccessor<PositionAttribute>(asset, positionAccessor,
-                                                             [&](const auto& value)
-                                                             {
-                                                                 forEach<0, 3>(
-                                                                     [&]<int i>
-                                                                     {
-                                                                         get<i>(min) = std::min(get<i>(min), value[i]);
-                                                                         get<i>(max) = std::max(get<i>(max), value[i]);
-                                                                     });
-                                                             });
-                forEach<0, 3>([&]<int i> { assert(get<i>(min) <= get<i>(max)); });
-
                 const auto& material =
-                    primitive.materialIndex ? materials.at(primitive.materialIndex.value()) : defaults.material;
-
-                const auto end = primitive.attributes.end();
+                    primitive.material ? materials.at(primitive.material.value()) : defaults.material;
                 mesh.primitives.emplace_back(
-                    partialIndexCount, indexCount, vertexCount, material,
+                    partialIndexCount, primitive.indexCount, primitive.vertexCount,
+                    static_cast<int32_t>(partialVertexCount), material,
                     Mesh::Primitive::Attributes {
-                        { geometry::Attribute::position, primitive.findAttribute("POSITION") != end },
-                        { geometry::Attribute::color, primitive.findAttribute("COLOR_0") != end },
-                        { geometry::Attribute::normal, primitive.findAttribute("NORMAL") != end },
-                        { geometry::Attribute::texCoord, primitive.findAttribute("TEXCOORD_0") != end },
-                        { geometry::Attribute::jointIndex, primitive.findAttribute("JOINTS_0") != end },
-                        { geometry::Attribute::jointWeight, primitive.findAttribute("WEIGHTS_0") != end },
+                        { geometry::Attribute::position, true },
+                        { geometry::Attribute::color, primitive.color },
+                        { geometry::Attribute::normal, primitive.normal },
+                        { geometry::Attribute::texCoord, primitive.texCoord },
+                        { geometry::Attribute::jointIndex, primitive.joints },
+                        { geometry::Attribute::jointWeight, primitive.weights },
                     },
-                    math::BoundingBox { min, max }, Mesh::Primitive::State { false });
+                    primitive.bounds, Mesh::Primitive::State { false });
 
-                partialIndexCount += indexCount;
+                partialIndexCount += primitive.indexCount;
+                partialVertexCount += primitive.vertexCount;
             }
+            mesh.weights = tableMesh.weights;
         }
         return meshes;
     }
 
-    Model createModel(const Command& command, const std::vector<Mesh>& meshes) const
+    // what the shaders read, zero where a primitive lacks it; joints and weights only go with skins. Colours are left
+    // out, no shader reading them
+    geometry::VertexLayout createLayout() const
+    {
+        std::set attributes {
+            geometry::Attribute::position,
+            geometry::Attribute::normal,
+            geometry::Attribute::texCoord,
+        };
+        if (!tables.skins.empty())
+        {
+            attributes.insert({ geometry::Attribute::jointIndex, geometry::Attribute::jointWeight });
+        }
+        geometry::VertexLayout layout { Vertex {}, attributes };
+        if (!tables.skins.empty() && !wideJoints())
+        {
+            layout.halve(geometry::Attribute::jointIndex);
+        }
+        return layout;
+    }
+
+    // whether a joint index may not fit in 8 bits
+    bool wideJoints() const
+    {
+        return std::any_of(tables.skins.begin(), tables.skins.end(), [](const GltfTables::Skin& skin)
+                           { return skin.joints.size() > Size { std::numeric_limits<UInt8>::max() } + 1; });
+    }
+
+    bool morphed() const
+    {
+        return tables.morphed();
+    }
+
+    // keeps only the vertices a target displaces, so that blending costs in proportion to the displaced vertices
+    std::vector<Mesh::MorphDelta> createMorphDeltas(std::vector<Mesh>& meshes)
+    {
+        if (!morphed())
+        {
+            return {};
+        }
+
+        Size targetCount { 0 };
+        for (const auto& mesh : meshes)
+        {
+            targetCount += mesh.weights.size();
+        }
+        const auto cachedDeltas  = cache.array<Mesh::MorphDelta>(AssetCache::Blob::morphDeltas);
+        const auto cachedTargets = cache.array<Mesh::MorphTarget>(AssetCache::Blob::morphTargets);
+        if (cachedDeltas && cachedTargets && cachedTargets->size() == targetCount)
+        {
+            auto target = cachedTargets->begin();
+            for (auto& mesh : meshes)
+            {
+                mesh.targets.assign(target, target + static_cast<std::ptrdiff_t>(mesh.weights.size()));
+                target += static_cast<std::ptrdiff_t>(mesh.weights.size());
+            }
+            return { cachedDeltas->begin(), cachedDeltas->end() };
+        }
+
+        constexpr auto displaced = [](const Mesh::MorphDelta& delta)
+        {
+            return delta.position[0] != 0 || delta.position[1] != 0 || delta.position[2] != 0 ||
+                   delta.normal[0] != 0 || delta.normal[1] != 0 || delta.normal[2] != 0;
+        };
+
+        const auto&                    asset = source();
+        std::vector<Mesh::MorphDelta>  deltas;
+        std::vector<Mesh::MorphDelta>  displacements;
+        std::vector<Mesh::MorphTarget> targets;
+        uint32_t                       vertexOffset { 0 };
+        for (std::size_t meshId = 0; meshId < asset.meshes.size(); ++meshId)
+        {
+            const auto& fastgltfMesh = asset.meshes[meshId];
+            auto&       mesh         = meshes.at(meshId);
+            mesh.targets.reserve(mesh.weights.size());
+            for (std::size_t target = 0; target < mesh.weights.size(); ++target)
+            {
+                const auto firstDelta = static_cast<uint32_t>(deltas.size());
+                auto       firstVertex { vertexOffset };
+                for (std::size_t primitiveId = 0; primitiveId < fastgltfMesh.primitives.size(); ++primitiveId)
+                {
+                    const auto& primitive   = fastgltfMesh.primitives[primitiveId];
+                    const auto  vertexCount = mesh.primitives.at(primitiveId).vertexCount;
+                    displacements.assign(vertexCount, Mesh::MorphDelta { { 0, 0, 0 }, 0, { 0, 0, 0 }, 0 });
+                    if (target < primitive.targets.size())
+                    {
+                        if (const auto values = primitive.findTargetAttribute(target, "POSITION");
+                            values != primitive.targets[target].end())
+                        {
+                            fastgltf::iterateAccessorWithIndex<math::Vector<3>>(
+                                asset, asset.accessors.at(values->accessorIndex),
+                                [&](const auto& value, const auto index) { displacements.at(index).position = value; });
+                        }
+                        if (const auto values = primitive.findTargetAttribute(target, "NORMAL");
+                            values != primitive.targets[target].end())
+                        {
+                            fastgltf::iterateAccessorWithIndex<math::Vector<3>>(
+                                asset, asset.accessors.at(values->accessorIndex),
+                                [&](const auto& value, const auto index) { displacements.at(index).normal = value; });
+                        }
+                    }
+                    for (uint32_t index = 0; index < vertexCount; ++index)
+                    {
+                        if (displaced(displacements[index]))
+                        {
+                            auto& delta  = deltas.emplace_back(displacements[index]);
+                            delta.vertex = firstVertex + index;
+                        }
+                    }
+                    firstVertex += vertexCount;
+                }
+                mesh.targets.push_back(
+                    Mesh::MorphTarget { firstDelta, static_cast<uint32_t>(deltas.size()) - firstDelta });
+                targets.push_back(mesh.targets.back());
+            }
+            for (const auto& primitive : mesh.primitives)
+            {
+                vertexOffset += primitive.vertexCount;
+            }
+        }
+        cache.store(AssetCache::Blob::morphDeltas, 0, std::as_bytes(std::span { deltas }));
+        cache.store(AssetCache::Blob::morphTargets, 0, std::as_bytes(std::span { targets }));
+        return deltas;
+    }
+
+    // 16 bit indices when every primitive fits them
+    Model createModel(const Command& command, const std::vector<Mesh>& meshes)
+    {
+        bool shortIndices { true };
+        for (const auto& mesh : meshes)
+        {
+            for (const auto& primitive : mesh.primitives)
+            {
+                shortIndices = shortIndices && geometry::fitsShortIndex(primitive.vertexCount);
+            }
+        }
+        return shortIndices ? createModel(command, meshes, std::type_identity<geometry::ShortIndex> {}) :
+                              createModel(command, meshes, std::type_identity<Index> {});
+    }
+
+    template<typename StoredIndex>
+    Model createModel(const Command& command, const std::vector<Mesh>& meshes, std::type_identity<StoredIndex>)
     {
         const auto [vertexCount, indexCount] = [&]
         {
@@ -404,6 +676,32 @@ public:
             return std::pair { vertexCount, indexCount };
         }();
 
+        const LoadTimer timer { loadStatistics.modelSeconds };
+        const auto      upload = [&](const auto& shape)
+        {
+            return tables.skins.empty() && !morphed() ? Model { command, shape, true, SceneModelInfo {} } :
+                                                        Model { command, shape, true, SkinnedModelInfo {} };
+        };
+
+        // blobs of the cache are copied straight into the staging buffers
+        const auto cachedVertices = cache.array<std::byte>(AssetCache::Blob::vertices);
+        const auto cachedIndices  = cache.array<StoredIndex>(AssetCache::Blob::indices);
+        if (cachedVertices && cachedIndices && cachedVertices->size() == layout.packedSize(vertexCount) &&
+            cachedIndices->size() == indexCount)
+        {
+            for (const auto& mesh : meshes)
+            {
+                for (const auto& primitive : mesh.primitives)
+                {
+                    loadStatistics.vertexCacheAfter += geometry::analyzeVertexCache(
+                        cachedIndices->subspan(primitive.firstIndex, primitive.indexCount), primitive.vertexCount);
+                }
+            }
+            return upload(
+                geometry::PackedShape { "asset", Size { vertexCount }, cachedVertices.value(), cachedIndices.value() });
+        }
+
+        const auto&         asset = source();
         std::vector<Vertex> vertices(vertexCount);
         std::vector<Index>  indices;
         indices.reserve(indexCount);
@@ -413,39 +711,92 @@ public:
         {
             for (const auto& primitive : mesh.primitives)
             {
+                const auto firstIndex = indices.size();
                 fastgltf::iterateAccessor<std::uint32_t>(asset, asset.accessors.at(primitive.indicesAccessor.value()),
-                                                         [&](std::uint32_t index)
-                                                         { indices.emplace_back(vertexOffset + index); });
-
-                constexpr std::array attributes {
-                    std::pair { "POSITION", geometry::Attribute::position },
-                    std::pair { "COLOR_0", geometry::Attribute::color },
-                    std::pair { "NORMAL", geometry::Attribute::normal },
-                    std::pair { "TEXCOORD_0", geometry::Attribute::texCoord },
-                    std::pair { "JOINTS_0", geometry::Attribute::jointIndex },
-                    std::pair { "WEIGHTS_0", geometry::Attribute::jointWeight },
-                };
-                forEach<0, attributes.size()>(
-                    [&]<int i>()
-                    {
-                        constexpr auto name      = attributes.at(i).first;
-                        constexpr auto attribute = attributes.at(i).second;
-                        using Attribute          = typename Vertex::Attribute<Vertex::attributeIndex<attribute>()>;
+                                                         [&](std::uint32_t index) { indices.emplace_back(index); });
 
-                        if (const auto values = primitive.findAttribute(name); values != primitive.attributes.end())
-                        {
-                            fastgltf::iterateAccessorWithIndex<typename Attribute::Value>(
-                                asset, asset.accessors.at(values->accessorIndex),
-                                [&](const auto& value, const auto index)
-                                { vertices.at(vertexOffset + index).template get<attribute>() = value; });
-                        }
-                    });
+                const auto read = [&]<typename Value>(const char* name, std::type_identity<Value>, const auto& store)
+                {
+                    if (const auto values = primitive.findAttribute(name); values != primitive.attributes.end())
+                    {
+                        fastgltf::iterateAccessorWithIndex<Value>(
+                            asset, asset.accessors.at(values->accessorIndex),
+                            [&](const Value& value, const auto index)
+                            { store(vertices.at(vertexOffset + index), value); });
+                    }
+                };
+                read("POSITION", std::type_identity<math::Vector<3>> {}, [](Vertex& vertex, const auto& value)
+                     { vertex.get<geometry::Attribute::position>() = value; });
+                read("NORMAL", std::type_identity<math::Vector<3>> {}, [](Vertex& vertex, const auto& value)
+                     { vertex.get<geometry::Attribute::normal>() = geometry::encodeOctahedral(value); });
+                read("TEXCOORD_0", std::type_identity<math::Vector<2>> {}, [](Vertex& vertex, const auto& value)
+                     {
+                         vertex.get<geometry::Attribute::texCoord>() = { geometry::quantizeHalf(value[0]),
+                                                                         geometry::quantizeHalf(value[1]) };
+                     });
+                read("JOINTS_0", std::type_identity<math::Vector<4>> {}, [&](Vertex& vertex, const auto& value)
+                     {
+                         auto& joints = vertex.get<geometry::Attribute::jointIndex>();
+                         for (Size i = 0; i < joints.size(); ++i)
+                         {
+                             if (value[i] > std::numeric_limits<UInt16>::max())
+                             {
+                                 throw std::runtime_error("joint index of '" + path.string() +
+                                                          "' out of the range of the vertex format");
+                             }
+                             joints[i] = static_cast<UInt16>(value[i]);
+                         }
+                     });
+                read("WEIGHTS_0", std::type_identity<math::Vector<4>> {}, [](Vertex& vertex, const auto& value)
+                     { vertex.get<geometry::Attribute::jointWeight>() = geometry::quantizeWeights(value); });
+
+                const auto primitiveVertexCount =
+                    asset.accessors.at(primitive.findAttribute("POSITION")->accessorIndex).count;
+                const auto primitiveIndices = std::span { indices }.subspan(firstIndex);
+                if (primitive.type == fastgltf::PrimitiveType::Triangles)
+                {
+                    optimize(primitiveIndices, std::span { vertices }.subspan(vertexOffset, primitiveVertexCount));
+                }
 
-                vertexOffset += asset.accessors.at(primitive.findAttribute("POSITION")->accessorIndex).count;
+                vertexOffset += primitiveVertexCount;
             }
         }
-        return Model { command, geometry::Shape { "asset", std::move(vertices), std::move(indices) }, true,
-                       SceneModelInfo {} };
+        auto packed = layout.pack(std::span<const Vertex> { vertices });
+        auto stored = [&]
+        {
+            if constexpr (std::is_same_v<StoredIndex, Index>)
+            {
+                return std::move(indices);
+            }
+            else
+            {
+                return geometry::narrowIndices(indices);
+            }
+        }();
+        cache.store(AssetCache::Blob::vertices, 0, packed);
+        cache.store(AssetCache::Blob::indices, 0, std::as_bytes(std::span { stored }));
+        return upload(geometry::PackedShape { "asset", vertices.size(), std::move(packed), std::move(stored) });
+    }
+
+    // reorders the triangles of a primitive for the vertex cache and overdraw, then its vertices for fetching; the
+    // vertices stay put when morph targets address them by their index in the source
+    void optimize(const std::span<Index> indices, const std::span<Vertex> vertices)
+    {
+        std::vector<math::Vector<3>> positions;
+        positions.reserve(vertices.size());
+        for (auto& vertex : vertices)
+        {
+            positions.push_back(vertex.template get<geometry::Attribute::position>());
+        }
+
+        loadStatistics.vertexCacheBefore += geometry::analyzeVertexCache(indices, vertices.size());
+        geometry::optimizeVertexCache(indices, vertices.size());
+        geometry::optimizeOverdraw(indices, positions);
+        if (!morphed())
+        {
+            geometry::optimizeVertexFetch(indices, vertices);
+        }
+        loadStatistics.vertexCacheAfter += geometry::analyzeVertexCache(indices, vertices.size());
     }
 
     static auto decomposeMatrix(const fastgltf::math::fmat4x4& matrix)
@@ -493,47 +844,32 @@ public:
                     std::vector<Node*>& nodesLut) const
     {
         assert(nodesLut.at(nodeId) == nullptr);
-        const auto& gltfNode = asset.nodes.at(nodeId);
-        assert(std::holds_alternative<fastgltf::TRS>(gltfNode.transform));
-        const auto& trs = std::get<fastgltf::TRS>(gltfNode.transform);
-
+        const auto& tableNode = tables.nodes.at(nodeId);
+        const auto* mesh      = tableNode.mesh ? &meshes.at(tableNode.mesh.value()) : nullptr;
 
         auto& node = nodes.emplace_back(
-            baptize<This::node>(gltfNode.name, nodeId),                             //
-            parent,                                                                 //
-            std::vector<Node> {},                                                   //
-            gltfNode.meshIndex ? &meshes.at(gltfNode.meshIndex.value()) : nullptr,  //
-            gltfNode.skinIndex ? std::optional<uint32_t> { static_cast<uint32_t>(gltfNode.skinIndex.value()) } :
-                                 std::optional<uint32_t> {},
+            tableNode.name,        //
+            parent,                //
+            std::vector<Node> {},  //
+            mesh,                  //
+            tableNode.skin,        //
             Node::State {
                 .active            = true,
                 .polygonMode       = PolygonMode::fill,
                 .vertexStageFlag   = 0,
                 .fragmentStageFlag = 0,
-                .translation =
-                    math::Vector<3> {
-                        trs.translation.x(),
-                        trs.translation.y(),
-                        trs.translation.z(),
-                    },
-                .rotation =
-                    math::Quaternion<> {
-                        trs.rotation.x(),
-                        trs.rotation.y(),
-                        trs.rotation.z(),
-                        trs.rotation.w(),
-                    },
-                .scale =
-                    math::Vector<3> {
-                        trs.scale.x(),
-                        trs.scale.y(),
-                        trs.scale.z(),
-                    },
+                .translation       = tableNode.translation,
+                .rotation          = tableNode.rotation,
+                .scale             = tableNode.scale,
+                // node weights override the ones of the mesh
+                .weights = mesh && tableNode.weights.size() == mesh->weights.size() ? tableNode.weights :
+                           mesh                                                       ? mesh->weights :
+                                                                                        std::vector<float> {},
             });
         nodesLut[nodeId] = &node;
 
-        node.children.reserve(gltfNode.children.size());
-        for (const auto& childId : gltfNode.children)
+        node.children.reserve(tableNode.children.size());
+        for (const auto& childId : tableNode.children)
         {
             createNode(node.children, &node, meshes, childId, nodesLut);
         }
@@ -542,14 +878,13 @@ public:
     std::vector<Scene> createScenes(const std::vector<Mesh>& meshes) const
     {
         std::vector<Scene> scenes;
-        scenes.reserve(asset.scenes.size());
-        uint32_t sceneId = 0;
-        for (const fastgltf::Scene& fastgltfScene : asset.scenes)
+        scenes.reserve(tables.scenes.size());
+        for (const auto& tableScene : tables.scenes)
         {
-            auto& scene = scenes.emplace_back(baptize<This::scene>(fastgltfScene.name, sceneId++));
-            scene.nodes.reserve(fastgltfScene.nodeIndices.size());
-            scene.nodesLut.resize(asset.nodes.size());
-            for (const auto nodeId : fastgltfScene.nodeIndices)
+            auto& scene = scenes.emplace_back(tableScene.name);
+            scene.nodes.reserve(tableScene.nodes.size());
+            scene.nodesLut.resize(tables.nodes.size());
+            for (const auto nodeId : tableScene.nodes)
             {
                 createNode(scene.nodes, nullptr, meshes, nodeId, scene.nodesLut);
             }
@@ -560,43 +895,318 @@ public:
 
     std::size_t mainSceneIndex() const
     {
-        return asset.defaultScene.value_or(0);
+        return tables.mainScene;
     }
 
     std::vector<Skin> createSkins(const std::vector<Node*>& nodesLut) const
     {
         std::vector<Skin> skins;
+        skins.reserve(tables.skins.size());
+        for (const auto& tableSkin : tables.skins)
+        {
+            const auto skeleton = tableSkin.skeleton ? nodesLut.at(tableSkin.skeleton.value()) : nullptr;
+            auto&      skin     = skins.emplace_back(tableSkin.name, skeleton);
+            skin.joints.reserve(tableSkin.joints.size());
+            for (std::size_t jointId = 0; jointId < tableSkin.joints.size(); ++jointId)
+            {
+                skin.joints.emplace_back(*nodesLut.at(tableSkin.joints[jointId]),
+                                         tableSkin.inverseBindMatrices.at(jointId));
+            }
+        }
+
+        return skins;
+    }
+
+    // compressed and baked as the import options ask, which the cache does not depend on
+    std::vector<Animation> createAnimations(const std::vector<Node*>& nodesLut) const
+    {
+        std::vector<Animation> animations;
+        animations.reserve(tables.animations.size());
+        for (const auto& tableAnimation : tables.animations)
+        {
+            std::vector<Animation::Sampler> samplers;
+            samplers.reserve(tableAnimation.samplers.size());
+            for (const auto& sampler : tableAnimation.samplers)
+            {
+                samplers.emplace_back(sampler.interpolation, sampler.inputs, sampler.outputs);
+            }
+
+            // channels without a target node are to be ignored (glTF 2.0, 3.11)
+            std::vector<Animation::Channel> channels;
+            channels.reserve(tableAnimation.channels.size());
+            auto firstLeafChannel = tableAnimation.firstLeafChannel;
+            for (std::size_t i = 0; i < tableAnimation.channels.size(); ++i)
+            {
+                const auto& channel = tableAnimation.channels[i];
+                if (nodesLut.at(channel.nodeIndex))
+                {
+                    channels.push_back(channel);
+                }
+                else if (i < tableAnimation.firstLeafChannel)
+                {
+                    --firstLeafChannel;
+                }
+            }
+
+            auto& animation = animations.emplace_back(tableAnimation.name, tableAnimation.start, tableAnimation.end,
+                                                      std::move(samplers), std::move(channels),
+                                                      static_cast<std::size_t>(firstLeafChannel));
+            if (animationOptions.tolerance)
+            {
+                animation.compress(animationOptions.tolerance.value());
+            }
+            if (animationOptions.bakeRate)
+            {
+                animation.bake(animationOptions.bakeRate.value(), animationOptions.bakeErrorBudget);
+            }
+        }
+        return animations;
+    }
+
+private:
+    GltfTables extractTables(const fastgltf::Asset& asset) const
+    {
+        GltfTables extracted;
+        extracted.textures   = extractTextures(asset);
+        extracted.materials  = extractMaterials(asset);
+        extracted.meshes     = extractMeshes(asset);
+        extracted.nodes      = extractNodes(asset);
+        extracted.scenes     = extractScenes(asset);
+        extracted.mainScene  = asset.defaultScene.value_or(0);
+        extracted.skins      = extractSkins(asset);
+        extracted.animations = extractAnimations(asset, extracted.meshes);
+        return extracted;
+    }
+
+    static std::vector<GltfTables::Texture> extractTextures(const fastgltf::Asset& asset)
+    {
+        std::vector<GltfTables::Texture> textures;
+        textures.reserve(asset.textures.size());
+        uint32_t textureId = 0;
+        for (const fastgltf::Texture& texture : asset.textures)
+        {
+            assert(texture.imageIndex && texture.imageIndex.value() < asset.images.size());
+            textures.push_back(GltfTables::Texture {
+                .name    = baptize<This::texture>(texture.name, textureId++),
+                .image   = static_cast<UInt32>(texture.imageIndex.value()),
+                .sampler = texture.samplerIndex ?
+                               std::optional<Sampler> { createSampler(asset, texture.samplerIndex.value()) } :
+                               std::nullopt,
+            });
+        }
+        return textures;
+    }
+
+    static std::vector<GltfTables::Material> extractMaterials(const fastgltf::Asset& asset)
+    {
+        constexpr auto extractTexture = [](const auto& textureInfo)
+        {
+            if (textureInfo)
+            {
+                return GltfTables::TextureSlot {
+                    .texture  = static_cast<UInt32>(textureInfo.value().textureIndex),
+                    .texCoord = static_cast<uint8_t>(textureInfo.value().texCoordIndex),
+                };
+            }
+            return GltfTables::TextureSlot { .texture = std::nullopt, .texCoord = 0 };
+        };
+
+        constexpr auto extractAlphaMode = [](const fastgltf::AlphaMode alphaMode)
+        {
+            switch (alphaMode)
+            {
+            case fastgltf::AlphaMode::Blend:
+                return Material::AlphaMode::blend;
+            case fastgltf::AlphaMode::Mask:
+                return Material::AlphaMode::mask;
+            case fastgltf::AlphaMode::Opaque:
+                return Material::AlphaMode::opaque;
+            }
+            throw;
+        };
+
+        std::vector<GltfTables::Material> materials;
+        materials.reserve(asset.materials.size());
+        uint32_t materialId = 0;
+        for (const fastgltf::Material& material : asset.materials)
+        {
+            const auto& baseColorFactor = material.pbrData.baseColorFactor;
+            const auto  normalScale     = material.normalTexture ? material.normalTexture.value().scale : 1.0f;
+            const auto  occlusionStrength =
+                material.occlusionTexture ? material.occlusionTexture.value().strength : 1.0f;
+            materials.push_back(GltfTables::Material {
+                .name                     = baptize<This::material>(material.name, materialId++),
+                .doubleSided              = material.doubleSided,
+                .unlit                    = material.unlit,
+                .alphaMode                = extractAlphaMode(material.alphaMode),
+                .alphaCutoff              = material.alphaCutoff,
+                .baseColorTexture         = extractTexture(material.pbrData.baseColorTexture),
+                .baseColorFactor          = { baseColorFactor[0], baseColorFactor[1], baseColorFactor[2],
+                                              baseColorFactor[3] },
+                .metallicRoughnessTexture = extractTexture(material.pbrData.metallicRoughnessTexture),
+                .metallicFactor           = material.pbrData.metallicFactor,
+                .roughnessFactor          = material.pbrData.roughnessFactor,
+                .emissiveTexture          = extractTexture(material.emissiveTexture),
+                .emissiveFactor           = { material.emissiveFactor[0], material.emissiveFactor[1],
+                                              material.emissiveFactor[2], 1 },
+                .emissiveStrength         = material.emissiveStrength,
+                .normalTexture            = extractTexture(material.normalTexture),
+                .normalScale              = normalScale,
+                .occlusionTexture         = extractTexture(material.occlusionTexture),
+                .occlusionStrength        = occlusionStrength,
+            });
+        }
+        return materials;
+    }
+
+    static std::vector<GltfTables::Mesh> extractMeshes(const fastgltf::Asset& asset)
+    {
+        std::vector<GltfTables::Mesh> meshes;
+        meshes.reserve(asset.meshes.size());
+        uint32_t meshId = 0;
+        for (const fastgltf::Mesh& fastgltfMesh : asset.meshes)
+        {
+            auto& mesh = meshes.emplace_back(baptize<This::mesh>(fastgltfMesh.name, meshId++));
+            mesh.primitives.reserve(fastgltfMesh.primitives.size());
+            for (const fastgltf::Primitive& primitive : fastgltfMesh.primitives)
+            {
+                const fastgltf::Accessor& positionAccessor =
+                    asset.accessors.at(primitive.findAttribute("POSITION")->accessorIndex);
+
+                constexpr auto  minValue = std::numeric_limits<math::Vector<3>::value_type>::lowest();
+                constexpr auto  maxValue = std::numeric_limits<math::Vector<3>::value_type>::max();
+                math::Vector<3> min { maxValue, maxValue, maxValue };
+                math::Vector<3> max { minValue, minValue, minValue };
+                using PositionAttribute =
+                    typename Vertex::Attribute<Vertex::attributeIndex<geometry::Attribute::position>()>::Value;
+                fastgltf::iterateAccessor<PositionAttribute>(asset, positionAccessor,
+                                                             [&](const auto& value)
+                                                             {
+                                                                 forEach<0, 3>(
+                                                                     [&]<int i>
+                                                                     {
+                                                                         get<i>(min) = std::min(get<i>(min), value[i]);
+                                                                         get<i>(max) = std::max(get<i>(max), value[i]);
+                                                                     });
+                                                             });
+                forEach<0, 3>([&]<int i> { assert(get<i>(min) <= get<i>(max)); });
+
+                const auto end = primitive.attributes.end();
+                mesh.primitives.push_back(GltfTables::Primitive {
+                    .indexCount  = static_cast<UInt32>(asset.accessors.at(primitive.indicesAccessor.value()).count),
+                    .vertexCount = static_cast<UInt32>(positionAccessor.count),
+                    .material    = primitive.materialIndex ?
+                                       std::optional<UInt32> { static_cast<UInt32>(primitive.materialIndex.value()) } :
+                                       std::nullopt,
+                    .color       = primitive.findAttribute("COLOR_0") != end,
+                    .normal      = primitive.findAttribute("NORMAL") != end,
+                    .texCoord    = primitive.findAttribute("TEXCOORD_0") != end,
+                    .joints      = primitive.findAttribute("JOINTS_0") != end,
+                    .weights     = primitive.findAttribute("WEIGHTS_0") != end,
+                    .bounds      = math::BoundingBox { min, max },
+                });
+            }
+
+            // all primitives of a mesh have the same number of targets (glTF 2.0, 3.7.2.2)
+            const auto targetCount =
+                fastgltfMesh.primitives.empty() ? 0 : fastgltfMesh.primitives.front().targets.size();
+            mesh.weights.resize(targetCount, 0.0f);
+            std::copy_n(fastgltfMesh.weights.begin(), std::min(targetCount, fastgltfMesh.weights.size()),
+                        mesh.weights.begin());
+        }
+        return meshes;
+    }
+
+    static std::vector<GltfTables::Node> extractNodes(const fastgltf::Asset& asset)
+    {
+        std::vector<GltfTables::Node> nodes;
+        nodes.reserve(asset.nodes.size());
+        for (std::size_t nodeId = 0; nodeId < asset.nodes.size(); ++nodeId)
+        {
+            const auto& gltfNode = asset.nodes[nodeId];
+            assert(std::holds_alternative<fastgltf::TRS>(gltfNode.transform));
+            const auto& trs      = std::get<fastgltf::TRS>(gltfNode.transform);
+            const auto  toIndex  = [](const auto& index)
+            {
+                return index ? std::optional<UInt32> { static_cast<UInt32>(index.value()) } : std::nullopt;
+            };
+            nodes.push_back(GltfTables::Node {
+                .name        = baptize<This::node>(gltfNode.name, static_cast<uint32_t>(nodeId)),
+                .mesh        = toIndex(gltfNode.meshIndex),
+                .skin        = toIndex(gltfNode.skinIndex),
+                .translation = { trs.translation.x(), trs.translation.y(), trs.translation.z() },
+                .rotation    = { trs.rotation.x(), trs.rotation.y(), trs.rotation.z(), trs.rotation.w() },
+                .scale       = { trs.scale.x(), trs.scale.y(), trs.scale.z() },
+                .weights     = { gltfNode.weights.begin(), gltfNode.weights.end() },
+                .children    = { gltfNode.children.begin(), gltfNode.children.end() },
+            });
+        }
+        return nodes;
+    }
+
+    static std::vector<GltfTables::Scene> extractScenes(const fastgltf::Asset& asset)
+    {
+        std::vector<GltfTables::Scene> scenes;
+        scenes.reserve(asset.scenes.size());
+        uint32_t sceneId = 0;
+        for (const fastgltf::Scene& fastgltfScene : asset.scenes)
+        {
+            scenes.push_back(GltfTables::Scene {
+                .name  = baptize<This::scene>(fastgltfScene.name, sceneId++),
+                .nodes = { fastgltfScene.nodeIndices.begin(), fastgltfScene.nodeIndices.end() },
+            });
+        }
+        return scenes;
+    }
+
+    static std::vector<GltfTables::Skin> extractSkins(const fastgltf::Asset& asset)
+    {
+        std::vector<GltfTables::Skin> skins;
         skins.reserve(asset.skins.size());
         uint32_t skinId = 0;
-
         for (const fastgltf::Skin& fastgltfSkin : asset.skins)
         {
-            const auto skeleton = fastgltfSkin.skeleton ? nodesLut.at(fastgltfSkin.skeleton.value()) : nullptr;
-            auto&      skin     = skins.emplace_back(baptize<This::skin>(fastgltfSkin.name, skinId++), skeleton);
-            skin.joints.reserve(fastgltfSkin.joints.size());
-            std::size_t jointId { 0 };
-            for (const auto joint : fastgltfSkin.joints)
+            auto& skin = skins.emplace_back(GltfTables::Skin {
+                .name     = baptize<This::skin>(fastgltfSkin.name, skinId++),
+                .skeleton = fastgltfSkin.skeleton ?
+                                std::optional<UInt32> { static_cast<UInt32>(fastgltfSkin.skeleton.value()) } :
+                                std::nullopt,
+                .joints              = { fastgltfSkin.joints.begin(), fastgltfSkin.joints.end() },
+                .inverseBindMatrices = {},
+            });
+            skin.inverseBindMatrices.reserve(fastgltfSkin.joints.size());
+            for (std::size_t jointId = 0; jointId < fastgltfSkin.joints.size(); ++jointId)
             {
                 assert(fastgltfSkin.inverseBindMatrices);
                 const auto& accessor = asset.accessors.at(fastgltfSkin.inverseBindMatrices.value());
-                skin.joints.emplace_back(
-                    *nodesLut.at(joint),
-                    math::transpose(fastgltf::getAccessorElement<math::Matrix<4, 4>>(asset, accessor, jointId++)));
+                skin.inverseBindMatrices.push_back(math::affine(
+                    math::transpose(fastgltf::getAccessorElement<math::Matrix<4, 4>>(asset, accessor, jointId))));
             }
         }
-
         return skins;
     }
 
-    std::vector<Animation> createAnimations(const std::vector<Node*>& nodesLut) const
+    // channels of nodes out of the first scene are kept, createAnimations drops them
+    std::vector<GltfTables::Animation> extractAnimations(const fastgltf::Asset&               asset,
+                                                         const std::vector<GltfTables::Mesh>& meshes) const
     {
-        std::vector<Animation> animations;
-        animations.reserve(asset.skins.size());
+        std::vector<GltfTables::Animation> animations;
+        animations.reserve(asset.animations.size());
         uint32_t animationId = 0;
+
+        // joints without children, the first to go with animation level of detail
+        std::vector<bool> leafJoints(asset.nodes.size(), false);
+        for (const fastgltf::Skin& fastgltfSkin : asset.skins)
+        {
+            for (const auto joint : fastgltfSkin.joints)
+            {
+                leafJoints.at(joint) = asset.nodes.at(joint).children.empty();
+            }
+        }
         for (const fastgltf::Animation& fastgltfAnimation : asset.animations)
         {
             // samplers
-            std::vector<Animation::Sampler> samplers;
+            std::vector<GltfTables::AnimationSampler> samplers;
             samplers.reserve(fastgltfAnimation.samplers.size());
             float start = std::numeric_limits<float>::max();
             float end   = std::numeric_limits<float>::min();
@@ -632,8 +1242,14 @@ public:
                                                                [&](const auto& value) { outputs.emplace_back(value); });
                     break;
                 }
-                case fastgltf::AccessorType::Invalid:
                 case fastgltf::AccessorType::Scalar:
+                {
+                    // morph target weights, regrouped by target once the channel tells which node they belong to
+                    fastgltf::iterateAccessor<float>(asset, outputAccessor, [&](const auto& value)
+                                                     { outputs.emplace_back(math::Vector<4> { value, 0, 0, 0 }); });
+                    break;
+                }
+                case fastgltf::AccessorType::Invalid:
                 case fastgltf::AccessorType::Vec2:
                 case fastgltf::AccessorType::Mat2:
                 case fastgltf::AccessorType::Mat3:
@@ -646,12 +1262,14 @@ public:
                     { fastgltf::AnimationInterpolation::Step, Animation::Sampler::Interpolation::step },
                     { fastgltf::AnimationInterpolation::CubicSpline, Animation::Sampler::Interpolation::cubicspline },
                 };
-                samplers.emplace_back(convert.at(fastgltfSampler.interpolation), std::move(inputs), std::move(outputs));
+                samplers.push_back(GltfTables::AnimationSampler { convert.at(fastgltfSampler.interpolation),
+                                                                  std::move(inputs), std::move(outputs) });
             }
 
             // channels
             std::vector<Animation::Channel> channels;
             channels.reserve(fastgltfAnimation.channels.size());
+            std::map<uint32_t, uint32_t> weightSamplers;  // scalar sampler to its first four-target sampler
             for (const auto& fastgltfChannel : fastgltfAnimation.channels)
             {
                 const std::map<fastgltf::AnimationPath, Animation::Channel::Path> convert {
@@ -660,43 +1278,290 @@ public:
                     { fastgltf::AnimationPath::Scale, Animation::Channel::Path::scale },
                     { fastgltf::AnimationPath::Weights, Animation::Channel::Path::weights },
                 };
-                const auto node = fastgltfChannel.nodeIndex ? nodesLut.at(fastgltfChannel.nodeIndex.value()) : nullptr;
-                channels.emplace_back(convert.at(fastgltfChannel.path), node, fastgltfChannel.samplerIndex);
+                // channels without a target node are to be ignored (glTF 2.0, 3.11)
+                if (!fastgltfChannel.nodeIndex)
+                {
+                    continue;
+                }
+                const auto path         = convert.at(fastgltfChannel.path);
+                const auto nodeIndex    = static_cast<uint32_t>(fastgltfChannel.nodeIndex.value());
+                const auto samplerIndex = static_cast<uint32_t>(fastgltfChannel.samplerIndex);
+                if (path != Animation::Channel::Path::weights)
+                {
+                    channels.emplace_back(path, nodeIndex, samplerIndex);
+                    continue;
+                }
+
+                // weights: one channel per four targets, so that they go through the same 4-lane kernel
+                const auto& mesh        = asset.nodes.at(nodeIndex).meshIndex;
+                const auto  targetCount = mesh ? static_cast<uint32_t>(meshes.at(mesh.value()).weights.size()) : 0;
+                if (targetCount == 0)
+                {
+                    continue;
+                }
+                const auto [weightSampler, inserted] =
+                    weightSamplers.try_emplace(samplerIndex, static_cast<uint32_t>(samplers.size()));
+                if (inserted)
+                {
+                    const auto interpolation = samplers.at(samplerIndex).interpolation;
+                    const auto inputs        = samplers.at(samplerIndex).inputs;
+                    const auto scalars       = std::move(samplers.at(samplerIndex).outputs);
+                    samplers.at(samplerIndex).outputs.clear();
+                    assert(scalars.size() % targetCount == 0);
+                    const auto elementCount = scalars.size() / targetCount;
+                    for (uint32_t target = 0; target < targetCount; target += 4)
+                    {
+                        std::vector<math::Vector<4>> outputs(elementCount, math::Vector<4> { 0, 0, 0, 0 });
+                        for (std::size_t element = 0; element < elementCount; ++element)
+                        {
+                            for (uint32_t k = 0; k < 4 && target + k < targetCount; ++k)
+                            {
+                                outputs[element][k] = scalars[element * targetCount + target + k][0];
+                            }
+                        }
+                        samplers.push_back(GltfTables::AnimationSampler { interpolation, inputs, std::move(outputs) });
+                    }
+                }
+                for (uint32_t target = 0; target < targetCount; target += 4)
+                {
+                    channels.emplace_back(path, nodeIndex, weightSampler->second + target / 4, target);
+                }
             }
 
-            animations.emplace_back(baptize<This::animation>(fastgltfAnimation.name, animationId++), start, end,
-                                    std::move(samplers), std::move(channels));
+            const auto firstLeafChannel = static_cast<UInt64>(std::distance(
+                channels.begin(),
+                std::stable_partition(channels.begin(), channels.end(), [&](const Animation::Channel& channel)
+                                      { return !leafJoints[channel.nodeIndex]; })));
+
+            animations.push_back(GltfTables::Animation {
+                .name             = baptize<This::animation>(fastgltfAnimation.name, animationId++),
+                .start            = start,
+                .end              = end,
+                .samplers         = std::move(samplers),
+                .channels         = std::move(channels),
+                .firstLeafChannel = firstLeafChannel,
+            });
         }
         return animations;
     }
 
-private:
-    static fastgltf::Asset createAsset(const std::filesystem::path& path)
+    // fastgltf reader over a mapped file: the json is parsed in place and the binary chunk of a glb is handed out as
+    // the memory of its buffer, so that nothing is copied; other buffers fastgltf asks for, those of data uris, are
+    // allocated on the heap, into allocations that outlive the reader
+    class MappedData : public fastgltf::GltfDataGetter
+    {
+    public:
+        MappedData(const std::span<const std::byte>           bytes,
+                   const Size                                 tail,
+                   std::vector<std::unique_ptr<std::byte[]>>& allocations)
+            : bytes { bytes }
+            , tail { tail }
+            , binaryChunk { findBinaryChunk(bytes) }
+            , allocations { allocations }
+        {
+        }
+
+        void read(void* destination, const std::size_t count) override
+        {
+            assert(offset + count <= bytes.size());
+            // the binary chunk, whose memory is the mapping itself
+            if (destination != bytes.data() + offset)
+            {
+                std::memcpy(destination, bytes.data() + offset, count);
+            }
+            offset += count;
+        }
+
+        fastgltf::span<std::byte> read(const std::size_t count, const std::size_t padding) override
+        {
+            assert(offset + count <= bytes.size());
+            auto* first = bytes.data() + offset;
+            offset += count;
+            // simdjson reads up to padding bytes past the json, still mapped unless it ends a file in a full page
+            if (offset + padding > bytes.size() + tail)
+            {
+                scratch.assign(first, first + count);
+                scratch.resize(count + padding);
+                return { scratch.data(), count };
+            }
+            return { const_cast<std::byte*>(first), count };
+        }
+
+        void reset() override
+        {
+            offset = 0;
+        }
+
+        std::size_t bytesRead() override
+        {
+            return offset;
+        }
+
+        std::size_t totalSize() override
+        {
+            return bytes.size();
+        }
+
+        // the buffer allocation callback of the parser, whose user pointer is this reader
+        static fastgltf::BufferInfo allocate(const std::uint64_t size, void* userPointer)
+        {
+            auto& data = *static_cast<MappedData*>(userPointer);
+
+            std::byte* memory;
+            if (data.binaryChunk && data.binaryChunk->data() == data.bytes.data() + data.offset &&
+                size <= data.binaryChunk->size())
+            {
+                memory = const_cast<std::byte*>(data.binaryChunk->data());
+            }
+            else
+            {
+                memory = data.allocations.emplace_back(std::make_unique<std::byte[]>(size)).get();
+                data.copiedBytes += size;
+            }
+            data.buffers.emplace_back(memory, size);
+            return fastgltf::BufferInfo { .mappedMemory = memory, .customId = data.buffers.size() - 1 };
+        }
+
+        fastgltf::sources::ByteView view(const fastgltf::sources::CustomBuffer& buffer) const
+        {
+            const auto bytes = buffers.at(buffer.id);
+            return fastgltf::sources::ByteView {
+                .bytes    = fastgltf::span<const std::byte> { bytes.data(), bytes.size() },
+                .mimeType = buffer.mimeType,
+            };
+        }
+
+        Size copiedBytes { 0 };
+
+    private:
+        std::span<const std::byte>                 bytes;
+        Size                                       tail;
+        std::optional<std::span<const std::byte>>  binaryChunk;
+        Size                                       offset { 0 };
+        // padded copy of a json too close to the end of the mapping
+        std::vector<std::byte>                     scratch;
+        std::vector<std::unique_ptr<std::byte[]>>& allocations;
+        std::vector<std::span<const std::byte>>    buffers;  // by custom buffer id
+
+        // glb: a 12 bytes header, then the json chunk and the optional binary chunk, each behind its length and type
+        static std::optional<std::span<const std::byte>> findBinaryChunk(const std::span<const std::byte> bytes)
+        {
+            constexpr uint32_t magic { 0x46546C67 };      // "glTF"
+            constexpr uint32_t binaryType { 0x004E4942 };  // "BIN"
+            const auto         word = [&](const Size at)
+            {
+                uint32_t value;
+                std::memcpy(&value, bytes.data() + at, sizeof(value));
+                return value;
+            };
+
+            if (bytes.size() < 20 || word(0) != magic)
+            {
+                return std::nullopt;
+            }
+            const Size binaryHeader = 20 + Size { word(12) };
+            if (binaryHeader + 8 > bytes.size() || word(binaryHeader + 4) != binaryType)
+            {
+                return std::nullopt;
+            }
+            const Size length = word(binaryHeader);
+            if (binaryHeader + 8 + length > bytes.size())
+            {
+                return std::nullopt;
+            }
+            return bytes.subspan(binaryHeader + 8, length);
+        }
+    };
+
+    // the glTF file, its external buffers and the images it refers to
+    UInt64 hashSources() const
+    {
+        UInt64 hash = fnv1a({});
+        for (const auto& source : sources)
+        {
+            hash = fnv1a(MappedFile { source }.bytes(), hash);
+        }
+        return hash;
+    }
+
+    // json or binary glTF; external buffers are mapped too, the accessors read all buffers in place
+    static fastgltf::Asset createAsset(const std::filesystem::path&               path,
+                                       std::vector<MappedFile>&                   files,
+                                       std::vector<std::unique_ptr<std::byte[]>>& allocations,
+                                       std::vector<std::filesystem::path>&        sources,
+                                       LoadStatistics&                            statistics)
     {
-        const auto errorMessage = [&](const fastgltf::Error error)
+        const LoadTimer timer { statistics.seconds };
+        const auto      errorMessage = [&](const fastgltf::Error error)
         {
             return "failed to load asset at path '" + path.string() +
                    "': " + std::string { fastgltf::getErrorName(error) };
         };
 
-        auto data = fastgltf::GltfDataBuffer::FromPath(path);
-        if (!data)
-        {
-            throw std::runtime_error(errorMessage(data.error()));
-        }
+        const auto& file = files.emplace_back(path);
+        sources.push_back(path);
+        MappedData  data { file.bytes(), file.tail(), allocations };
 
-        [[maybe_unused]] const auto type = fastgltf::determineGltfFileType(data.get());
-        assert(type == fastgltf::GltfType::glTF);
+        fastgltf::Parser parser;
+        parser.setUserPointer(&data);
+        parser.setBufferAllocationCallback(MappedData::allocate);
 
         constexpr auto options = fastgltf::Options::DontRequireValidAssetMember | fastgltf::Options::AllowDouble |
-                                 fastgltf::Options::DecomposeNodeMatrices | fastgltf::Options::LoadExternalBuffers;
-        auto load = fastgltf::Parser().loadGltfJson(data.get(), path.parent_path(), options);
+                                 fastgltf::Options::DecomposeNodeMatrices;
+        auto load = parser.loadGltf(data, path.parent_path(), options);
         if (!load)
         {
             throw std::runtime_error(errorMessage(load.error()));
         }
+        auto& asset = load.get();
+
+        for (auto& buffer : asset.buffers)
+        {
+            if (const auto* custom = std::get_if<fastgltf::sources::CustomBuffer>(&buffer.data))
+            {
+                buffer.data = data.view(*custom);
+            }
+            else if (const auto* uri = std::get_if<fastgltf::sources::URI>(&buffer.data))
+            {
+                if (!uri->uri.isLocalPath())
+                {
+                    throw std::runtime_error("asset at path '" + path.string() + "': buffer '" +
+                                             std::string { uri->uri.string() } + "' is not a local file");
+                }
+                const auto& external = files.emplace_back(sources.emplace_back(path.parent_path() / uri->uri.path()));
+                if (uri->fileByteOffset + buffer.byteLength > external.bytes().size())
+                {
+                    throw std::runtime_error("asset at path '" + path.string() + "': buffer '" +
+                                             std::string { uri->uri.string() } + "' is truncated");
+                }
+                const auto bytes = external.bytes().subspan(uri->fileByteOffset, buffer.byteLength);
+                buffer.data      = fastgltf::sources::ByteView {
+                    .bytes    = fastgltf::span<const std::byte> { bytes.data(), bytes.size() },
+                    .mimeType = uri->mimeType,
+                };
+            }
+        }
+        for (auto& image : asset.images)
+        {
+            if (const auto* custom = std::get_if<fastgltf::sources::CustomBuffer>(&image.data))
+            {
+                image.data = data.view(*custom);
+            }
+            else if (const auto* uri = std::get_if<fastgltf::sources::URI>(&image.data))
+            {
+                sources.push_back(path.parent_path() / uri->uri.path());
+            }
+        }
+
+        statistics.mappedBytes = 0;
+        for (const auto& mapped : files)
+        {
+            statistics.mappedBytes += mapped.bytes().size();
+        }
+        statistics.copiedBytes       = data.copiedBytes;
+        statistics.peakResidentBytes = peakResidentBytes();
 
-        return std::move(load.get());
+        return std::move(asset);
     }
 };
 
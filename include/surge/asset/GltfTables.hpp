@@ -0,0 +1,217 @@
+#pragma once
+
+#include "surge/Texture.hpp"
+#include "surge/asset/Animation.hpp"
+#include "surge/asset/AssetCache.hpp"
+#include "surge/asset/Material.hpp"
+#include "surge/math/BoundingBox.hpp"
+#include "surge/math/Quaternion.hpp"
+#include "surge/math/Vector.hpp"
+#include "surge/math/matrices.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace surge::asset
+{
+
+// what an import keeps of the glTF document besides the bulk data, as plain tables referring to each other by
+// index: the cache stores them, so that a warm load builds the asset without parsing the document. Names are the
+// ones given to the asset objects, animations are kept as extracted, before compression or baking
+struct GltfTables
+{
+    struct Texture
+    {
+        std::string            name;
+        UInt32                 image;
+        std::optional<Sampler> sampler;  // the default sampler otherwise
+
+        template<typename Archive, typename Self>
+        static void fields(Archive& archive, Self& self)
+        {
+            archive(self.name, self.image, self.sampler);
+        }
+    };
+
+    struct TextureSlot
+    {
+        std::optional<UInt32> texture;  // the default texture otherwise
+        UInt8                 texCoord;
+    };
+
+    struct Material
+    {
+        std::string                name;
+        bool                       doubleSided;
+        bool                       unlit;
+        asset::Material::AlphaMode alphaMode;
+        float                      alphaCutoff;
+        TextureSlot                baseColorTexture;
+        math::Vector<4>            baseColorFactor;
+        TextureSlot                metallicRoughnessTexture;
+        float                      metallicFactor;
+        float                      roughnessFactor;
+        TextureSlot                emissiveTexture;
+        math::Vector<4>            emissiveFactor;
+        float                      emissiveStrength;
+        TextureSlot                normalTexture;
+        float                      normalScale;
+        TextureSlot                occlusionTexture;
+        float                      occlusionStrength;
+
+        template<typename Archive, typename Self>
+        static void fields(Archive& archive, Self& self)
+        {
+            archive(self.name, self.doubleSided, self.unlit, self.alphaMode, self.alphaCutoff, self.baseColorTexture,
+                    self.baseColorFactor, self.metallicRoughnessTexture, self.metallicFactor, self.roughnessFactor,
+                    self.emissiveTexture, self.emissiveFactor, self.emissiveStrength, self.normalTexture,
+                    self.normalScale, self.occlusionTexture, self.occlusionStrength);
+        }
+    };
+
+    struct Primitive
+    {
+        UInt32                indexCount;
+        UInt32                vertexCount;
+        std::optional<UInt32> material;  // the default material otherwise
+        bool                  color;
+        bool                  normal;
+        bool                  texCoord;
+        bool                  joints;
+        bool                  weights;
+        math::BoundingBox     bounds;
+    };
+
+    struct Mesh
+    {
+        std::string            name;
+        std::vector<Primitive> primitives;
+        std::vector<float>     weights;  // one per morph target
+
+        template<typename Archive, typename Self>
+        static void fields(Archive& archive, Self& self)
+        {
+            archive(self.name, self.primitives, self.weights);
+        }
+    };
+
+    struct Node
+    {
+        std::string           name;
+        std::optional<UInt32> mesh;
+        std::optional<UInt32> skin;
+        math::Vector<3>       translation;
+        math::Quaternion<>    rotation;
+        math::Vector<3>       scale;
+        std::vector<float>    weights;  // of the node itself, which override the ones of its mesh
+        std::vector<UInt32>   children;
+
+        template<typename Archive, typename Self>
+        static void fields(Archive& archive, Self& self)
+        {
+            archive(self.name, self.mesh, self.skin, self.translation, self.rotation, self.scale, self.weights,
+                    self.children);
+        }
+    };
+
+    struct Scene
+    {
+        std::string         name;
+        std::vector<UInt32> nodes;
+
+        template<typename Archive, typename Self>
+        static void fields(Archive& archive, Self& self)
+        {
+            archive(self.name, self.nodes);
+        }
+    };
+
+    struct Skin
+    {
+        std::string                 name;
+        std::optional<UInt32>       skeleton;
+        std::vector<UInt32>         joints;
+        std::vector<math::Affine<>> inverseBindMatrices;
+
+        template<typename Archive, typename Self>
+        static void fields(Archive& archive, Self& self)
+        {
+            archive(self.name, self.skeleton, self.joints, self.inverseBindMatrices);
+        }
+    };
+
+    struct AnimationSampler
+    {
+        asset::Animation::Sampler::Interpolation interpolation;
+        std::vector<float>                       inputs;
+        std::vector<math::Vector<4>>             outputs;
+
+        template<typename Archive, typename Self>
+        static void fields(Archive& archive, Self& self)
+        {
+            archive(self.interpolation, self.inputs, self.outputs);
+        }
+    };
+
+    struct Animation
+    {
+        std::string                            name;
+        float                                  start;
+        float                                  end;
+        std::vector<AnimationSampler>          samplers;
+        std::vector<asset::Animation::Channel> channels;
+        UInt64                                 firstLeafChannel;
+
+        template<typename Archive, typename Self>
+        static void fields(Archive& archive, Self& self)
+        {
+            archive(self.name, self.start, self.end, self.samplers, self.channels, self.firstLeafChannel);
+        }
+    };
+
+    std::vector<Texture>   textures;
+    std::vector<Material>  materials;
+    std::vector<Mesh>      meshes;
+    std::vector<Node>      nodes;
+    std::vector<Scene>     scenes;
+    UInt64                 mainScene;
+    std::vector<Skin>      skins;
+    std::vector<Animation> animations;
+
+    template<typename Archive, typename Self>
+    static void fields(Archive& archive, Self& self)
+    {
+        archive(self.textures, self.materials, self.meshes, self.nodes, self.scenes, self.mainScene, self.skins,
+                self.animations);
+    }
+
+    bool morphed() const
+    {
+        return std::any_of(meshes.begin(), meshes.end(), [](const Mesh& mesh) { return !mesh.weights.empty(); });
+    }
+
+    std::vector<std::byte> write() const
+    {
+        TableWriter writer;
+        writer(*this);
+        return std::move(writer.bytes);
+    }
+
+    // throws if the bytes are not tables
+    static GltfTables read(const std::span<const std::byte> bytes)
+    {
+        GltfTables  tables;
+        TableReader reader { bytes };
+        reader(tables);
+        if (!reader.empty())
+        {
+            throw std::runtime_error("trailing bytes after the asset cache tables");
+        }
+        return tables;
+    }
+};
+
+}  // namespace surge::asset
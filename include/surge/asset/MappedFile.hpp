@@ -0,0 +1,150 @@
+#pragma once
+
+#include "surge/types.hpp"
+
+// files are mapped with mmap where there is one, elsewhere they are read into the heap
+#if defined(__unix__) || defined(__APPLE__)
+#define SURGE_MAPPED_FILE_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace surge::asset
+{
+
+// read-only mapping of a whole file, paged in from the page cache on first access rather than read into the heap;
+// without POSIX the file is read whole instead
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& path)
+    {
+        const auto fail = [&](const std::string& what)
+        { return std::runtime_error("failed to " + what + " '" + path.string() + "': " + std::strerror(errno)); };
+
+#if defined(SURGE_MAPPED_FILE_POSIX)
+        const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (descriptor < 0)
+        {
+            throw fail("open");
+        }
+        struct stat status;
+        if (::fstat(descriptor, &status) != 0)
+        {
+            ::close(descriptor);
+            throw fail("stat");
+        }
+        size = static_cast<Size>(status.st_size);
+        if (size > 0)
+        {
+            data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        }
+        // the mapping keeps its own reference to the file
+        ::close(descriptor);
+        if (data == MAP_FAILED)
+        {
+            data = nullptr;
+            throw fail("map");
+        }
+#else
+        std::ifstream file { path, std::ios::binary | std::ios::ate };
+        if (!file)
+        {
+            throw fail("open");
+        }
+        size = static_cast<Size>(file.tellg());
+        if (size > 0)
+        {
+            data = new std::byte[size];
+            file.seekg(0);
+            if (!file.read(static_cast<char*>(data), static_cast<std::streamsize>(size)))
+            {
+                delete[] static_cast<std::byte*>(data);
+                data = nullptr;
+                throw fail("read");
+            }
+        }
+#endif
+    }
+
+    MappedFile(MappedFile&& other) noexcept
+        : data { std::exchange(other.data, nullptr) }
+        , size { std::exchange(other.size, 0) }
+    {
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+        return *this;
+    }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        if (data)
+        {
+#if defined(SURGE_MAPPED_FILE_POSIX)
+            ::munmap(data, size);
+#else
+            delete[] static_cast<std::byte*>(data);
+#endif
+        }
+    }
+
+    std::span<const std::byte> bytes() const
+    {
+        return { static_cast<const std::byte*>(data), size };
+    }
+
+    // readable bytes past the end of the file: the zero filled rest of its last page, none when read into the heap
+    Size tail() const
+    {
+#if defined(SURGE_MAPPED_FILE_POSIX)
+        const auto page = static_cast<Size>(::sysconf(_SC_PAGESIZE));
+        return size == 0 ? 0 : (page - size % page) % page;
+#else
+        return 0;
+#endif
+    }
+
+private:
+    void* data { nullptr };
+    Size  size { 0 };
+};
+
+// high-water mark of the resident set of the process, 0 where it is unknown
+Size peakResidentBytes();
+
+inline Size peakResidentBytes()
+{
+#if defined(SURGE_MAPPED_FILE_POSIX)
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<Size>(usage.ru_maxrss);  // bytes on macOS
+#else
+    return static_cast<Size>(usage.ru_maxrss) * 1024;  // kilobytes on Linux and the BSDs
+#endif
+#else
+    return 0;
+#endif
+}
+
+}  // namespace surge::asset
@@ -12,6 +12,7 @@ struct Mesh
         uint32_t        firstIndex;
         uint32_t        indexCount;
         uint32_t        vertexCount;
+        int32_t         vertexOffset;  // of the first vertex, which the indices are relative to
         const Material& material;
 
         // bool color;
@@ -37,13 +38,50 @@ struct Mesh
         // }
     };
 
+    // displacements of one target, as a range of the asset's sparse morph deltas covering all primitives
+    struct MorphTarget
+    {
+        uint32_t firstDelta;
+        uint32_t deltaCount;
+    };
+
+    // displacement of one vertex by one target, laid out as read by morph.comp
+    struct MorphDelta
+    {
+        math::Vector<3> position;
+        uint32_t        vertex;  // into the asset vertices
+        math::Vector<3> normal;
+        float           padding;
+    };
+    static_assert(sizeof(MorphDelta) == 32);
+
     Mesh(const std::string& name)
         : name { name }
         , primitives {}
+        , targets {}
+        , weights {}
     {
     }
 
-    std::string            name;
-    std::vector<Primitive> primitives;
+    std::string              name;
+    std::vector<Primitive>   primitives;
+    std::vector<MorphTarget> targets;
+    std::vector<float>       weights;  // default target weights of nodes instancing the mesh
+
+    // the primitives of a mesh are consecutive in the model vertex buffer
+    uint32_t firstVertex() const
+    {
+        return primitives.empty() ? 0 : static_cast<uint32_t>(primitives.front().vertexOffset);
+    }
+
+    uint32_t vertexCount() const
+    {
+        uint32_t count { 0 };
+        for (const auto& primitive : primitives)
+        {
+            count += primitive.vertexCount;
+        }
+        return count;
+    }
 };
 }  // namespace surge::asset
\ No newline at end of file
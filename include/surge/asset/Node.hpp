@@ -3,6 +3,7 @@
 #include "surge/Defaults.hpp"
 #include "surge/asset/Mesh.hpp"
 #include "surge/math/angles.hpp"
+#include "surge/math/matrices.hpp"
 // #include "glm/gtx/quaternion.hpp"
 
 namespace surge::asset
@@ -19,6 +20,7 @@ struct Node
         math::Vector<3>    translation { 0, 0, 0 };
         math::Quaternion<> rotation { 0, 0, 0, 0 };
         math::Vector<3>    scale { 1, 1, 1 };
+        std::vector<float> weights {};  // one per morph target of the mesh
     };
 
     std::string             name;
@@ -27,9 +29,11 @@ struct Node
     const Mesh*             mesh;
     std::optional<uint32_t> skinIndex;
     mutable State           state;
+    uint32_t                jointOffset { 0 };     // first joint of its palette in the joint matrices ssbo
+    uint32_t                deformedVertex { 0 };  // first of its own range of the deformed vertices
 
 
-    math::Matrix<4, 4> localMatrix() const
+    math::Affine<> localMatrix() const
     {
         // const auto               sintheta { std::sin(math::deg2rad(180.0f)) };
         // const auto               costheta { std::cos(math::deg2rad(180.0f)) };
@@ -48,13 +52,13 @@ struct Node
         // };
         // return math::transpose(math::Translation { translation } * math::Rotation { state.rotation } *
         //                        math::Scaling { state.scale } * correction);
-        return math::Translation { state.translation } * math::Rotation { state.rotation } *
-               math::Scaling { state.scale };
+        return math::affine(math::Translation { state.translation }, math::Rotation { state.rotation },
+                            math::Scaling { state.scale });
         // return math::Scaling { state.scale } * math::Rotation { state.rotation } *
         //        math::Translation { state.translation };
     }
 
-    math::Matrix<4, 4> globalMatrix() const
+    math::Affine<> globalMatrix() const
     {
         auto  nodeMatrix    = localMatrix();
         auto* currentParent = parent;
@@ -2,13 +2,16 @@
 
 #include "surge/asset/LoadedTexture.hpp"
 #include "surge/asset/Node.hpp"
+#include "surge/geometry/indices.hpp"
+#include "surge/geometry/optimize.hpp"
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 
 #include <filesystem>
-#include <numeric>
+#include <map>
 #include <optional>
+#include <tuple>
 #include <vector>
 
 namespace surge::asset
@@ -42,6 +45,7 @@ public:
         {
             throw std::runtime_error(warn + err);
         }
+        weld();
     }
 
     std::vector<Texture> createTextures(const Command& command, const Defaults& defaults) const
@@ -105,11 +109,8 @@ public:
 
     std::vector<Mesh> createMesh(const Defaults& defaults, const std::vector<Material>& materials) const
     {
-        Size indexCount {};
-        for (const auto& shape : shapes)
-        {
-            indexCount += shape.mesh.indices.size();
-        }
+        const auto indexCount  = indices.size();
+        const auto vertexCount = corners.size();
 
         const auto& material = materials.size() > 0 ? materials.front() : defaults.material;
 
@@ -136,7 +137,7 @@ public:
 
         std::vector<Mesh> meshes;
         auto&             mesh = meshes.emplace_back(baptize<This::mesh>(0));
-        mesh.primitives.emplace_back(0, indexCount, indexCount, material,
+        mesh.primitives.emplace_back(0, indexCount, vertexCount, 0, material,
                                      Mesh::Primitive::Attributes {
                                          { geometry::Attribute::position, true },
                                          { geometry::Attribute::color, false },
@@ -159,38 +160,53 @@ public:
 
         std::vector<Vertex> vertices;
         vertices.reserve(vertexCount);
-        for (const auto& shape : shapes)
+        for (const auto& index : corners)
         {
-            for (const auto& index : shape.mesh.indices)
-            {
-                const auto vertexIdx   = 3 * index.vertex_index;
-                const auto normalIdx   = 3 * index.normal_index;
-                const auto texCoordIdx = 2 * index.texcoord_index;
-
-                vertices.emplace_back(
-                    Vertex::Attribute<Vertex::attributeIndex<geometry::Attribute::position>()>::Value {
-                        attrib.vertices.at(vertexIdx + 0),
-                        attrib.vertices.at(vertexIdx + 1),
-                        attrib.vertices.at(vertexIdx + 2),
-                    },
-                    Vertex::Attribute<Vertex::attributeIndex<geometry::Attribute::color>()>::Value { 1.0f, 1.0f, 1.0f,
-                                                                                                     1.0f },
-                    Vertex::Attribute<Vertex::attributeIndex<geometry::Attribute::normal>()>::Value {
-                        attrib.normals.at(normalIdx + 0),
-                        attrib.normals.at(normalIdx + 1),
-                        attrib.normals.at(normalIdx + 2),
-                    },
-                    Vertex::Attribute<Vertex::attributeIndex<geometry::Attribute::texCoord>()>::Value {
-                        attrib.texcoords.at(texCoordIdx + 0),
-                        1.0f - attrib.texcoords.at(texCoordIdx + 1),
-                    });
-            }
+            const auto vertexIdx   = 3 * index.vertex_index;
+            const auto normalIdx   = 3 * index.normal_index;
+            const auto texCoordIdx = 2 * index.texcoord_index;
+
+            vertices.emplace_back(
+                Vertex::Attribute<Vertex::attributeIndex<geometry::Attribute::position>()>::Value {
+                    attrib.vertices.at(vertexIdx + 0),
+                    attrib.vertices.at(vertexIdx + 1),
+                    attrib.vertices.at(vertexIdx + 2),
+                },
+                Vertex::Attribute<Vertex::attributeIndex<geometry::Attribute::color>()>::Value { 1.0f, 1.0f, 1.0f,
+                                                                                                 1.0f },
+                Vertex::Attribute<Vertex::attributeIndex<geometry::Attribute::normal>()>::Value {
+                    attrib.normals.at(normalIdx + 0),
+                    attrib.normals.at(normalIdx + 1),
+                    attrib.normals.at(normalIdx + 2),
+                },
+                Vertex::Attribute<Vertex::attributeIndex<geometry::Attribute::texCoord>()>::Value {
+                    attrib.texcoords.at(texCoordIdx + 0),
+                    1.0f - attrib.texcoords.at(texCoordIdx + 1),
+                });
         }
 
-        std::vector<Index> indices(vertexCount);
-        std::iota(indices.begin(), indices.end(), 0);
+        // reordered for the vertex cache and overdraw, then the vertices for fetching
+        auto                         optimized = indices;
+        std::vector<math::Vector<3>> positions;
+        positions.reserve(vertices.size());
+        for (auto& vertex : vertices)
+        {
+            positions.push_back(vertex.get<geometry::Attribute::position>());
+        }
+        vertexCacheBefore = geometry::analyzeVertexCache(optimized, vertices.size());
+        geometry::optimizeVertexCache(optimized, vertices.size());
+        geometry::optimizeOverdraw(optimized, positions);
+        geometry::optimizeVertexFetch(std::span { optimized }, std::span { vertices });
+        vertexCacheAfter = geometry::analyzeVertexCache(optimized, vertices.size());
 
-        return Model { command, geometry::Shape { "asset", std::move(vertices), std::move(indices) }, true,
+        // the single primitive starts at the first vertex
+        if (geometry::fitsShortIndex(vertices.size()))
+        {
+            return Model { command,
+                           geometry::Shape { "asset", std::move(vertices), geometry::narrowIndices(optimized) }, true,
+                           SceneModelInfo {} };
+        }
+        return Model { command, geometry::Shape { "asset", std::move(vertices), std::move(optimized) }, true,
                        SceneModelInfo {} };
     }
 
@@ -230,6 +246,33 @@ public:
     std::vector<tinyobj::shape_t>    shapes;
     std::vector<tinyobj::material_t> materials;
     std::optional<LoadedTexture>     texture;
+
+    std::vector<tinyobj::index_t> corners;  // distinct combinations of position, normal and texture coordinates
+    std::vector<Index>            indices;  // into the corners, three per triangle
+
+    mutable geometry::CacheStatistics vertexCacheBefore;
+    mutable geometry::CacheStatistics vertexCacheAfter;
+
+private:
+    // obj faces index positions, normals and texture coordinates separately; a vertex is each combination in use
+    void weld()
+    {
+        std::map<std::tuple<int, int, int>, Index> welded;
+        for (const auto& shape : shapes)
+        {
+            for (const auto& index : shape.mesh.indices)
+            {
+                const auto [corner, inserted] = welded.try_emplace(
+                    std::tuple { index.vertex_index, index.normal_index, index.texcoord_index },
+                    static_cast<Index>(corners.size()));
+                if (inserted)
+                {
+                    corners.push_back(index);
+                }
+                indices.push_back(corner->second);
+            }
+        }
+    }
 };
 
 }  // namespace surge::asset
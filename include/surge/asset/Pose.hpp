@@ -0,0 +1,138 @@
+#pragma once
+
+#include "surge/asset/Node.hpp"
+
+namespace surge::asset
+{
+
+// local transforms of all nodes of a scene in SoA layout, indexed like Scene::nodesLut
+struct Pose
+{
+    std::vector<math::Vector<3>>    translations;
+    std::vector<math::Quaternion<>> rotations;
+    std::vector<math::Vector<3>>    scales;
+    std::vector<std::vector<float>> weights;  // morph target weights, empty for nodes without targets
+
+    Pose() = default;
+
+    explicit Pose(const std::vector<Node*>& nodesLut)
+    {
+        translations.reserve(nodesLut.size());
+        rotations.reserve(nodesLut.size());
+        scales.reserve(nodesLut.size());
+        weights.reserve(nodesLut.size());
+        for (const auto* node : nodesLut)
+        {
+            translations.emplace_back(node ? node->state.translation : math::Vector<3> { 0, 0, 0 });
+            rotations.emplace_back(node ? node->state.rotation : math::Quaternion<> { 0, 0, 0, 1 });
+            scales.emplace_back(node ? node->state.scale : math::Vector<3> { 1, 1, 1 });
+            weights.emplace_back(node ? node->state.weights : std::vector<float> {});
+        }
+    }
+
+    std::size_t size() const
+    {
+        return translations.size();
+    }
+
+    void clear()
+    {
+        std::fill(translations.begin(), translations.end(), math::Vector<3> { 0, 0, 0 });
+        std::fill(rotations.begin(), rotations.end(), math::Quaternion<> { 0, 0, 0, 0 });
+        std::fill(scales.begin(), scales.end(), math::Vector<3> { 0, 0, 0 });
+        for (auto& nodeWeights : weights)
+        {
+            std::fill(nodeWeights.begin(), nodeWeights.end(), 0.0f);
+        }
+    }
+
+    // adds weight * clip, with rotations flipped onto the hemisphere of the reference so that the sum is an nlerp
+    void accumulate(const Pose& clip, const Pose& reference, const float weight)
+    {
+        assert(clip.size() == size() && reference.size() == size());
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            translations[i] = translations[i] + weight * clip.translations[i];
+        }
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            const auto sign = math::dot(clip.rotations[i], reference.rotations[i]) < 0 ? -weight : weight;
+            rotations[i]    = rotations[i] + sign * clip.rotations[i];
+        }
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            scales[i] = scales[i] + weight * clip.scales[i];
+        }
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            for (std::size_t j = 0; j < weights[i].size(); ++j)
+            {
+                weights[i][j] += weight * clip.weights[i][j];
+            }
+        }
+    }
+
+    // turns an accumulated sum of total weight into a pose; weight missing to reach one is taken from the reference
+    void resolve(const Pose& reference, const float totalWeight)
+    {
+        if (totalWeight < 1)
+        {
+            accumulate(reference, reference, 1 - totalWeight);
+        }
+        const auto normalization = 1 / std::max(totalWeight, 1.0f);
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            translations[i] = normalization * translations[i];
+            scales[i]       = normalization * scales[i];
+            for (auto& targetWeight : weights[i])
+            {
+                targetWeight *= normalization;
+            }
+        }
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            rotations[i] = math::normalize(rotations[i]);
+        }
+    }
+
+    // layers the difference between clip and reference on top of this pose
+    void add(const Pose& clip, const Pose& reference, const float weight)
+    {
+        assert(clip.size() == size() && reference.size() == size());
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            translations[i] = translations[i] + weight * (clip.translations[i] - reference.translations[i]);
+            scales[i]       = scales[i] + weight * (clip.scales[i] - reference.scales[i]);
+            for (std::size_t j = 0; j < weights[i].size(); ++j)
+            {
+                weights[i][j] += weight * (clip.weights[i][j] - reference.weights[i][j]);
+            }
+        }
+        constexpr math::Quaternion<> identity { 0, 0, 0, 1 };
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            auto delta = math::multiply(math::conjugate(reference.rotations[i]), clip.rotations[i]);
+            if (math::get<3>(delta) < 0)
+            {
+                delta = -delta;
+            }
+            rotations[i] = math::normalize(math::multiply(rotations[i], math::lerp(identity, delta, weight)));
+        }
+    }
+
+    void apply(const std::vector<Node*>& nodesLut) const
+    {
+        assert(nodesLut.size() == size());
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            if (auto* node = nodesLut[i])
+            {
+                node->state.translation = translations[i];
+                node->state.rotation    = rotations[i];
+                node->state.scale       = scales[i];
+                node->state.weights     = weights[i];
+            }
+        }
+    }
+};
+}  // namespace surge::asset
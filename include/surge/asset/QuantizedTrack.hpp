@@ -0,0 +1,167 @@
+#pragma once
+
+#include "surge/math/math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace surge::asset
+{
+
+// animation outputs packed in 48 bits per key
+// - quaternion48: smallest three components in 15 bits each, index of the dropped largest component in two spare bits
+// - fixed48:      three components as 16 bit fixed point over the range of the track
+struct QuantizedTrack
+{
+    enum class Encoding
+    {
+        quaternion48,
+        fixed48,
+    };
+
+    using Key = std::array<uint16_t, 3>;
+
+    Encoding         encoding;
+    math::Vector<3>  offset { 0, 0, 0 };
+    math::Vector<3>  extent { 0, 0, 0 };
+    std::vector<Key> keys;
+
+    static constexpr float    sqrt1_2 { 0.70710678118654752440f };
+    static constexpr uint16_t maxQ15 { 0x7fff };
+    static constexpr uint16_t maxQ16 { 0xffff };
+
+    // largest component error of a decoded quaternion: half a step on the three stored components, and at most
+    // three times the step on the largest, which is at least one half
+    static constexpr float quaternionError { 3 * sqrt1_2 / maxQ15 };
+
+    static QuantizedTrack encodeQuaternions(const std::vector<math::Vector<4>>& outputs)
+    {
+        QuantizedTrack track {};
+        track.encoding = Encoding::quaternion48;
+        track.keys.reserve(outputs.size());
+        for (const auto& output : outputs)
+        {
+            const auto q       = math::normalize(output);
+            uint16_t   largest = 0;
+            for (uint16_t i = 1; i < 4; ++i)
+            {
+                if (std::abs(q[i]) > std::abs(q[largest]))
+                {
+                    largest = i;
+                }
+            }
+            // q and -q are the same rotation: flip so that the dropped component is positive
+            const auto sign = q[largest] < 0 ? -1.0f : 1.0f;
+
+            Key      key {};
+            uint16_t slot = 0;
+            for (uint16_t i = 0; i < 4; ++i)
+            {
+                if (i != largest)
+                {
+                    const auto unit = std::clamp((sign * q[i] + sqrt1_2) / (2 * sqrt1_2), 0.0f, 1.0f);
+                    key[slot++]     = static_cast<uint16_t>(std::lround(unit * maxQ15));
+                }
+            }
+            key[0] |= static_cast<uint16_t>((largest & 1) << 15);
+            key[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+            track.keys.push_back(key);
+        }
+        return track;
+    }
+
+    // smallest corner and size of the box holding the first three components of outputs
+    static std::pair<math::Vector<3>, math::Vector<3>> range(const std::vector<math::Vector<4>>& outputs)
+    {
+        if (outputs.empty())
+        {
+            return {};
+        }
+        math::Vector<3> min { outputs.front()[0], outputs.front()[1], outputs.front()[2] };
+        math::Vector<3> max { min };
+        for (const auto& output : outputs)
+        {
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                min[i] = std::min(min[i], output[i]);
+                max[i] = std::max(max[i], output[i]);
+            }
+        }
+        return { min, max - min };
+    }
+
+    // largest component error of the fixed point encoding of outputs: half a step over the widest range
+    static float fixedError(const std::vector<math::Vector<4>>& outputs)
+    {
+        const auto extent = range(outputs).second;
+        return std::max({ extent[0], extent[1], extent[2] }) / (2.0f * maxQ16);
+    }
+
+    static QuantizedTrack encodeFixed(const std::vector<math::Vector<4>>& outputs)
+    {
+        QuantizedTrack track {};
+        track.encoding = Encoding::fixed48;
+        if (outputs.empty())
+        {
+            return track;
+        }
+        std::tie(track.offset, track.extent) = range(outputs);
+
+        track.keys.reserve(outputs.size());
+        for (const auto& output : outputs)
+        {
+            Key key {};
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                const auto unit = track.extent[i] > 0 ? (output[i] - track.offset[i]) / track.extent[i] : 0.0f;
+                key[i]          = static_cast<uint16_t>(std::lround(std::clamp(unit, 0.0f, 1.0f) * maxQ16));
+            }
+            track.keys.push_back(key);
+        }
+        return track;
+    }
+
+    math::Vector<4> decode(const std::size_t index) const
+    {
+        const auto& key = keys[index];
+        if (encoding == Encoding::fixed48)
+        {
+            constexpr auto scale = 1.0f / maxQ16;
+            return {
+                offset[0] + extent[0] * (key[0] * scale),
+                offset[1] + extent[1] * (key[1] * scale),
+                offset[2] + extent[2] * (key[2] * scale),
+                0.0f,
+            };
+        }
+
+        constexpr auto scale   = 2 * sqrt1_2 / maxQ15;
+        const auto     largest = static_cast<std::size_t>((key[0] >> 15) | ((key[1] >> 15) << 1));
+
+        math::Vector<4> q;
+        float           sum { 0 };
+        std::size_t     slot { 0 };
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            if (i != largest)
+            {
+                q[i] = (key[slot++] & maxQ15) * scale - sqrt1_2;
+                sum += q[i] * q[i];
+            }
+        }
+        q[largest] = std::sqrt(std::max(0.0f, 1 - sum));
+        return q;
+    }
+
+    std::size_t bytes() const
+    {
+        return sizeof(Key) * keys.size();
+    }
+};
+
+}  // namespace surge::asset
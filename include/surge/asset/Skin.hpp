@@ -15,7 +15,7 @@ struct Skin
     struct Joint
     {
         const Node&        node;
-        math::Matrix<4, 4> inverseBindMatrix;
+        math::Affine<>     inverseBindMatrix;
     };
 
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -68,4 +69,51 @@ public:
     Vertices    vertices;
     Indices     indices;
 };
+
+// vertices packed to a VertexLayout, as bytes
+template<typename Bytes, typename Indices>
+class PackedShape
+{
+public:
+    using Index = typename Indices::value_type;
+
+    PackedShape(const std::string& name, const Size vertexCount, const Bytes& bytes, const Indices& indices)
+        : name { name }
+        , vertexCount { vertexCount }
+        , bytes { bytes }
+        , indices { indices }
+    {
+    }
+
+    Size vertexSize() const
+    {
+        return vertexCount;
+    }
+    Size vertexBufferSize() const
+    {
+        return bytes.size();
+    }
+    const std::byte* vertexData() const
+    {
+        return bytes.data();
+    }
+
+    Size indexSize() const
+    {
+        return indices.size();
+    }
+    Size indexBufferSize() const
+    {
+        return sizeof(Index) * indexSize();
+    }
+    const Index* indexData() const
+    {
+        return indices.data();
+    }
+
+    std::string name;
+    Size        vertexCount;
+    Bytes       bytes;
+    Indices     indices;
+};
 }  // namespace surge::geometry
\ No newline at end of file
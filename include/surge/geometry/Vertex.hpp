@@ -2,12 +2,16 @@
 
 namespace surge::geometry
 {
-using Index = UInt32;
+using Index      = UInt32;
+using ShortIndex = UInt16;
 
+// how the shader reads the components; their width follows from the size of the value
 enum class Format
 {
     sfloat,
     unorm,
+    snorm,
+    uint,
 };
 
 enum class Attribute
@@ -24,7 +28,8 @@ enum class Attribute
 };
 
 
-template<Attribute _attribute, typename _Value, UInt32 _size, Format _format>
+// the binding is the vertex stream the slot is read from; the streams of a vertex follow each other in the buffer
+template<Attribute _attribute, typename _Value, UInt32 _size, Format _format, UInt32 _binding = 0>
     requires((sizeof(_Value) % _size == 0))
 class AttributeSlot
 {
@@ -33,6 +38,7 @@ public:
     static constexpr auto attribute = _attribute;
     static constexpr auto size      = _size;
     static constexpr auto format    = _format;
+    static constexpr auto binding   = _binding;
 
     Value value;
 };
@@ -52,6 +58,7 @@ public:
 
 
     static constexpr auto attributeCount = sizeof...(Attributes);
+    static constexpr auto bindingCount   = std::max({ Attributes::binding... }) + 1;
 
     template<typename Requested>
     static constexpr bool hasAttribute = std::is_base_of_v<Requested, Self>;
@@ -96,6 +103,29 @@ public:
         return offset;
     }
 
+    // within the stream of the slot
+    template<geometry::Attribute requested>
+    static constexpr UInt32 computeBindingOffset()
+    {
+        constexpr auto binding = Attribute<attributeIndex<requested>()>::binding;
+        UInt32         offset {};
+        forEach<0, attributeIndex<requested>()>(
+            [&]<int index>()
+            {
+                if constexpr (Attribute<index>::binding == binding)
+                {
+                    offset += sizeof(Attribute<index>);
+                }
+            });
+        return offset;
+    }
+
+    template<UInt32 binding>
+    static constexpr UInt32 computeStride()
+    {
+        return ((Attributes::binding == binding ? sizeof(Attributes) : 0) + ...);
+    }
+
     constexpr Vertex()
         : Attributes {}...
     {
@@ -139,26 +169,51 @@ private:
     }
 };
 
-template<Size size, geometry::Format format>
+template<Size size, Size componentBytes, geometry::Format format>
 constexpr VkFormat extractFormat()
 {
     constexpr std::array lut {
-        std::pair { std::pair { 1, geometry::Format::sfloat }, VK_FORMAT_R32_SFLOAT },
-        std::pair { std::pair { 2, geometry::Format::sfloat }, VK_FORMAT_R32G32_SFLOAT },
-        std::pair { std::pair { 3, geometry::Format::sfloat }, VK_FORMAT_R32G32B32_SFLOAT },
-        std::pair { std::pair { 4, geometry::Format::sfloat }, VK_FORMAT_R32G32B32A32_SFLOAT },
-        std::pair { std::pair { 1, geometry::Format::unorm }, VK_FORMAT_R8_UNORM },
-        std::pair { std::pair { 2, geometry::Format::unorm }, VK_FORMAT_R8G8_UNORM },
-        std::pair { std::pair { 3, geometry::Format::unorm }, VK_FORMAT_R8G8B8_UNORM },
-        std::pair { std::pair { 4, geometry::Format::unorm }, VK_FORMAT_R8G8B8A8_UNORM },
+        std::pair { std::tuple { 1, 4, geometry::Format::sfloat }, VK_FORMAT_R32_SFLOAT },
+        std::pair { std::tuple { 2, 4, geometry::Format::sfloat }, VK_FORMAT_R32G32_SFLOAT },
+        std::pair { std::tuple { 3, 4, geometry::Format::sfloat }, VK_FORMAT_R32G32B32_SFLOAT },
+        std::pair { std::tuple { 4, 4, geometry::Format::sfloat }, VK_FORMAT_R32G32B32A32_SFLOAT },
+        std::pair { std::tuple { 1, 2, geometry::Format::sfloat }, VK_FORMAT_R16_SFLOAT },
+        std::pair { std::tuple { 2, 2, geometry::Format::sfloat }, VK_FORMAT_R16G16_SFLOAT },
+        std::pair { std::tuple { 3, 2, geometry::Format::sfloat }, VK_FORMAT_R16G16B16_SFLOAT },
+        std::pair { std::tuple { 4, 2, geometry::Format::sfloat }, VK_FORMAT_R16G16B16A16_SFLOAT },
+        std::pair { std::tuple { 1, 2, geometry::Format::unorm }, VK_FORMAT_R16_UNORM },
+        std::pair { std::tuple { 2, 2, geometry::Format::unorm }, VK_FORMAT_R16G16_UNORM },
+        std::pair { std::tuple { 3, 2, geometry::Format::unorm }, VK_FORMAT_R16G16B16_UNORM },
+        std::pair { std::tuple { 4, 2, geometry::Format::unorm }, VK_FORMAT_R16G16B16A16_UNORM },
+        std::pair { std::tuple { 1, 2, geometry::Format::snorm }, VK_FORMAT_R16_SNORM },
+        std::pair { std::tuple { 2, 2, geometry::Format::snorm }, VK_FORMAT_R16G16_SNORM },
+        std::pair { std::tuple { 3, 2, geometry::Format::snorm }, VK_FORMAT_R16G16B16_SNORM },
+        std::pair { std::tuple { 4, 2, geometry::Format::snorm }, VK_FORMAT_R16G16B16A16_SNORM },
+        std::pair { std::tuple { 1, 2, geometry::Format::uint }, VK_FORMAT_R16_UINT },
+        std::pair { std::tuple { 2, 2, geometry::Format::uint }, VK_FORMAT_R16G16_UINT },
+        std::pair { std::tuple { 3, 2, geometry::Format::uint }, VK_FORMAT_R16G16B16_UINT },
+        std::pair { std::tuple { 4, 2, geometry::Format::uint }, VK_FORMAT_R16G16B16A16_UINT },
+        std::pair { std::tuple { 1, 1, geometry::Format::unorm }, VK_FORMAT_R8_UNORM },
+        std::pair { std::tuple { 2, 1, geometry::Format::unorm }, VK_FORMAT_R8G8_UNORM },
+        std::pair { std::tuple { 3, 1, geometry::Format::unorm }, VK_FORMAT_R8G8B8_UNORM },
+        std::pair { std::tuple { 4, 1, geometry::Format::unorm }, VK_FORMAT_R8G8B8A8_UNORM },
+        std::pair { std::tuple { 1, 1, geometry::Format::snorm }, VK_FORMAT_R8_SNORM },
+        std::pair { std::tuple { 2, 1, geometry::Format::snorm }, VK_FORMAT_R8G8_SNORM },
+        std::pair { std::tuple { 3, 1, geometry::Format::snorm }, VK_FORMAT_R8G8B8_SNORM },
+        std::pair { std::tuple { 4, 1, geometry::Format::snorm }, VK_FORMAT_R8G8B8A8_SNORM },
+        std::pair { std::tuple { 1, 1, geometry::Format::uint }, VK_FORMAT_R8_UINT },
+        std::pair { std::tuple { 2, 1, geometry::Format::uint }, VK_FORMAT_R8G8_UINT },
+        std::pair { std::tuple { 3, 1, geometry::Format::uint }, VK_FORMAT_R8G8B8_UINT },
+        std::pair { std::tuple { 4, 1, geometry::Format::uint }, VK_FORMAT_R8G8B8A8_UINT },
     };
 
-    VkFormat result;
+    VkFormat result { VK_FORMAT_UNDEFINED };
     forEach<0, lut.size()>(
         [&]<int i>()
         {
             constexpr auto t = lut.at(i);
-            if constexpr (t.first.first == size && t.first.second == format)
+            if constexpr (std::get<0>(t.first) == size && std::get<1>(t.first) == componentBytes &&
+                          std::get<2>(t.first) == format)
             {
                 result = t.second;
             }
@@ -177,31 +232,41 @@ static constexpr auto createAttributeDescriptions(geometry::Vertex<Attributes...
             using Attribute              = typename Vertex::Attribute<index>;
             attributeDescriptions[index] = {
                 .location = index,
-                .binding  = 0,
-                .format   = extractFormat<Attribute::size, Attribute::format>(),
-                .offset   = Vertex::template computeByteOffset<Attribute::attribute>(),
+                .binding  = Attribute::binding,
+                .format   = extractFormat<Attribute::size, sizeof(typename Attribute::Value) / Attribute::size,
+                                              Attribute::format>(),
+                .offset   = Vertex::template computeBindingOffset<Attribute::attribute>(),
             };
         });
     return attributeDescriptions;
 }
 
+// the streams of a vertex with several bindings are bound one by one
 template<typename Vertex>
 VkPipelineVertexInputStateCreateInfo createVertexInputState()
 {
-    static constexpr VkVertexInputBindingDescription bindingDescription {
-        .binding   = 0,
-        .stride    = sizeof(Vertex),
-        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-
-    };
+    static constexpr auto bindingDescriptions = []
+    {
+        std::array<VkVertexInputBindingDescription, Vertex::bindingCount> descriptions;
+        forEach<0, Vertex::bindingCount>(
+            [&]<int binding>()
+            {
+                descriptions[binding] = {
+                    .binding   = binding,
+                    .stride    = Vertex::template computeStride<binding>(),
+                    .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+                };
+            });
+        return descriptions;
+    }();
     static constexpr auto attributeDescriptions = createAttributeDescriptions(Vertex {});
 
     static constexpr VkPipelineVertexInputStateCreateInfo vertexInputState {
         .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .pNext                           = nullptr,
         .flags                           = {},
-        .vertexBindingDescriptionCount   = 1,
-        .pVertexBindingDescriptions      = &bindingDescription,
+        .vertexBindingDescriptionCount   = static_cast<uint32_t>(bindingDescriptions.size()),
+        .pVertexBindingDescriptions      = bindingDescriptions.data(),
         .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size()),
         .pVertexAttributeDescriptions    = attributeDescriptions.data(),
     };
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "surge/types.hpp"
+#include "surge/geometry/Vertex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+#include <set>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace surge::geometry
+{
+
+// descriptions of the vertex input of a pipeline, which have to outlive its creation
+struct VertexInputState
+{
+    std::vector<VkVertexInputBindingDescription>   bindings;
+    std::vector<VkVertexInputAttributeDescription> attributes;
+
+    VkPipelineVertexInputStateCreateInfo createInfo() const
+    {
+        return {
+            .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+            .pNext                           = nullptr,
+            .flags                           = {},
+            .vertexBindingDescriptionCount   = static_cast<uint32_t>(bindings.size()),
+            .pVertexBindingDescriptions      = bindings.data(),
+            .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributes.size()),
+            .pVertexAttributeDescriptions    = attributes.data(),
+        };
+    }
+};
+
+// the slots of a vertex type an asset has, chosen at run time and packed in the order of the type, so that vertices
+// only carry what is present or read by the shaders. Locations and bindings stay those of the full type, which the
+// shaders use; each binding is a stream of its own, the streams following each other aligned
+class VertexLayout
+{
+public:
+    struct Slot
+    {
+        Attribute attribute;
+        UInt32    location;
+        UInt32    binding;
+        VkFormat  format;
+        UInt32    components;
+        UInt32    size;              // in bytes
+        UInt32    source;            // offset in the full vertex
+        UInt32    offset;            // in the packed vertex of its stream
+        bool      halved { false };  // integer components stored in half the width they have in the full vertex
+    };
+
+    static constexpr Size streamAlignment { 16 };
+
+    // every slot of the type
+    template<typename... Attributes>
+    explicit VertexLayout(const Vertex<Attributes...> vertex)
+        : VertexLayout { vertex, std::set { Attributes::attribute... } }
+    {
+    }
+
+    template<typename... Attributes>
+    VertexLayout(Vertex<Attributes...>, const std::set<Attribute>& present)
+        : strides(Vertex<Attributes...>::bindingCount, 0)
+        , sourceStride { sizeof(Vertex<Attributes...>) }
+    {
+        using Full = Vertex<Attributes...>;
+        forEach<0, Full::attributeCount>(
+            [&]<int index>()
+            {
+                using AttributeSlot = typename Full::template Attribute<index>;
+                if (present.contains(AttributeSlot::attribute))
+                {
+                    constexpr auto size = static_cast<UInt32>(sizeof(typename AttributeSlot::Value));
+                    auto&          stride = strides.at(AttributeSlot::binding);
+                    slots.push_back(Slot {
+                        .attribute  = AttributeSlot::attribute,
+                        .location   = index,
+                        .binding    = AttributeSlot::binding,
+                        .format     = extractFormat<AttributeSlot::size, size / AttributeSlot::size,
+                                                    AttributeSlot::format>(),
+                        .components = AttributeSlot::size,
+                        .size       = size,
+                        .source     = Full::template computeByteOffset<AttributeSlot::attribute>(),
+                        .offset     = stride,
+                    });
+                    stride += size;
+                }
+            });
+    }
+
+    // stores the integer components of a slot in half their width in the full vertex, keeping their low bytes, for
+    // values the caller knows to fit; the slots after it in its stream move up
+    void halve(const Attribute attribute)
+    {
+        static constexpr std::array halvedFormats {
+            std::pair { VK_FORMAT_R16G16B16A16_UINT, VK_FORMAT_R8G8B8A8_UINT },
+            std::pair { VK_FORMAT_R16G16_UINT, VK_FORMAT_R8G8_UINT },
+            std::pair { VK_FORMAT_R16_UINT, VK_FORMAT_R8_UINT },
+            std::pair { VK_FORMAT_R32G32B32A32_UINT, VK_FORMAT_R16G16B16A16_UINT },
+            std::pair { VK_FORMAT_R32G32_UINT, VK_FORMAT_R16G16_UINT },
+            std::pair { VK_FORMAT_R32_UINT, VK_FORMAT_R16_UINT },
+        };
+        const auto found =
+            std::find_if(slots.begin(), slots.end(), [&](const Slot& slot) { return slot.attribute == attribute; });
+        assert(found != slots.end());
+        auto&      halved = *found;
+        const auto format = std::find_if(halvedFormats.begin(), halvedFormats.end(),
+                                         [&](const auto& formats) { return formats.first == halved.format; });
+        assert(!halved.halved && format != halvedFormats.end());
+        halved.format = format->second;
+        halved.size /= 2;
+        halved.halved = true;
+
+        auto& stride = strides.at(halved.binding);
+        stride       = 0;
+        for (auto& slot : slots)
+        {
+            if (slot.binding == halved.binding)
+            {
+                slot.offset = stride;
+                stride += slot.size;
+            }
+        }
+    }
+
+    bool has(const Attribute attribute) const
+    {
+        return std::any_of(slots.begin(), slots.end(), [&](const Slot& slot) { return slot.attribute == attribute; });
+    }
+
+    const Slot& slot(const Attribute attribute) const
+    {
+        const auto found =
+            std::find_if(slots.begin(), slots.end(), [&](const Slot& slot) { return slot.attribute == attribute; });
+        assert(found != slots.end());
+        return *found;
+    }
+
+    // bytes of a vertex over all streams
+    UInt32 vertexSize() const
+    {
+        return std::accumulate(strides.begin(), strides.end(), UInt32 { 0 });
+    }
+
+    // of the stream of a binding, or the size of all streams past the last one
+    Size streamOffset(const UInt32 binding, const Size vertexCount) const
+    {
+        Size offset { 0 };
+        for (UInt32 previous = 0; previous < binding; ++previous)
+        {
+            offset += (vertexCount * strides[previous] + streamAlignment - 1) / streamAlignment * streamAlignment;
+        }
+        return offset;
+    }
+
+    Size packedSize(const Size vertexCount) const
+    {
+        return streamOffset(static_cast<UInt32>(strides.size()), vertexCount);
+    }
+
+    // copies the present slots of full vertices into their streams
+    template<typename Vertex>
+    std::vector<std::byte> pack(const std::span<const Vertex> vertices) const
+    {
+        assert(sizeof(Vertex) == sourceStride);
+        std::vector<std::byte> packed(packedSize(vertices.size()));
+        for (const auto& slot : slots)
+        {
+            const auto stream = packed.data() + streamOffset(slot.binding, vertices.size());
+            for (Size i = 0; i < vertices.size(); ++i)
+            {
+                const auto target = stream + i * strides[slot.binding] + slot.offset;
+                const auto source = reinterpret_cast<const std::byte*>(&vertices[i]) + slot.source;
+                if (!slot.halved)
+                {
+                    std::memcpy(target, source, slot.size);
+                    continue;
+                }
+                // little endian: the low half of a component comes first
+                static_assert(std::endian::native == std::endian::little);
+                const auto width = slot.size / slot.components;
+                for (UInt32 component = 0; component < slot.components; ++component)
+                {
+                    std::memcpy(target + component * width, source + 2 * component * width, width);
+                }
+            }
+        }
+        return packed;
+    }
+
+    // every slot
+    VertexInputState vertexInputState() const
+    {
+        std::set<Attribute> attributes;
+        for (const auto& slot : slots)
+        {
+            attributes.insert(slot.attribute);
+        }
+        return vertexInputState(attributes);
+    }
+
+    // the slots a pipeline reads and the streams that hold them, such as the positions alone for depth passes
+    VertexInputState vertexInputState(const std::set<Attribute>& read) const
+    {
+        VertexInputState state;
+        for (const auto& slot : slots)
+        {
+            if (!read.contains(slot.attribute))
+            {
+                continue;
+            }
+            if (std::none_of(state.bindings.begin(), state.bindings.end(),
+                             [&](const auto& binding) { return binding.binding == slot.binding; }))
+            {
+                state.bindings.push_back(VkVertexInputBindingDescription {
+                    .binding   = slot.binding,
+                    .stride    = strides[slot.binding],
+                    .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+                });
+            }
+            state.attributes.push_back(VkVertexInputAttributeDescription {
+                .location = slot.location,
+                .binding  = slot.binding,
+                .format   = slot.format,
+                .offset   = slot.offset,
+            });
+        }
+        return state;
+    }
+
+    std::vector<Slot>   slots;
+    std::vector<UInt32> strides;       // of each stream
+    UInt32              sourceStride;  // of the full vertex
+};
+
+}  // namespace surge::geometry
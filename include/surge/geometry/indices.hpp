@@ -0,0 +1,37 @@
+#pragma once
+
+#include "surge/types.hpp"
+#include "surge/geometry/Vertex.hpp"
+
+#include <cassert>
+#include <limits>
+#include <span>
+#include <vector>
+
+// indices are stored relative to the first vertex of their primitive, which the draw passes as its vertex offset, so
+// that meshes whose primitives are small enough draw from 16 bit indices
+namespace surge::geometry
+{
+
+constexpr bool fitsShortIndex(Size vertexCount);
+
+std::vector<ShortIndex> narrowIndices(std::span<const Index> indices);
+
+constexpr bool fitsShortIndex(const Size vertexCount)
+{
+    return vertexCount <= Size { std::numeric_limits<ShortIndex>::max() } + 1;
+}
+
+inline std::vector<ShortIndex> narrowIndices(const std::span<const Index> indices)
+{
+    std::vector<ShortIndex> narrowed;
+    narrowed.reserve(indices.size());
+    for (const auto index : indices)
+    {
+        assert(index <= std::numeric_limits<ShortIndex>::max());
+        narrowed.push_back(static_cast<ShortIndex>(index));
+    }
+    return narrowed;
+}
+
+}  // namespace surge::geometry
@@ -0,0 +1,424 @@
+#pragma once
+
+#include "surge/types.hpp"
+#include "surge/geometry/Vertex.hpp"
+#include "surge/math/Vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+
+// import-time reordering of indexed triangle lists: triangles for the post-transform vertex cache, then clusters of
+// them for overdraw, then vertices for fetch locality. Indices address vertices [0, vertexCount)
+namespace surge::geometry
+{
+
+// transformed vertices over a fifo cache of the given size, the way the hardware is usually modelled
+struct CacheStatistics
+{
+    Size triangles { 0 };
+    Size vertices { 0 };  // referenced
+    Size transformed { 0 };
+
+    // average cache miss ratio: transformed per triangle, 0.5 at best on large regular meshes, 3 at worst
+    double acmr() const
+    {
+        return triangles == 0 ? 0 : static_cast<double>(transformed) / static_cast<double>(triangles);
+    }
+
+    // average transformed to vertex ratio: 1 at best
+    double atvr() const
+    {
+        return vertices == 0 ? 0 : static_cast<double>(transformed) / static_cast<double>(vertices);
+    }
+
+    CacheStatistics& operator+=(const CacheStatistics& other)
+    {
+        triangles += other.triangles;
+        vertices += other.vertices;
+        transformed += other.transformed;
+        return *this;
+    }
+};
+
+// indices of either width
+template<typename Indices>
+CacheStatistics analyzeVertexCache(const Indices& indices, const Size vertexCount, const Size cacheSize = 16)
+{
+    assert(std::size(indices) % 3 == 0);
+
+    CacheStatistics   statistics { .triangles = std::size(indices) / 3, .vertices = 0, .transformed = 0 };
+    std::vector<Size> cached(vertexCount, 0);  // time at which a vertex entered the cache
+    std::vector<bool> referenced(vertexCount, false);
+    Size              time { cacheSize + 1 };
+    for (const Size index : indices)
+    {
+        assert(index < vertexCount);
+        if (time - cached[index] > cacheSize)
+        {
+            cached[index] = time++;
+            ++statistics.transformed;
+        }
+        if (!referenced[index])
+        {
+            referenced[index] = true;
+            ++statistics.vertices;
+        }
+    }
+    return statistics;
+}
+
+// Forsyth, Linear-Speed Vertex Cache Optimisation: greedily emits the triangle whose vertices score best in a
+// simulated lru cache, favouring recently used vertices and those with few triangles left
+void optimizeVertexCache(std::span<Index> indices, Size vertexCount);
+
+// Sander, Nehab and Barczak, Fast Triangle Reordering for Vertex Locality and Reduced Overdraw: cuts the cache
+// optimized order into clusters where the cache restarts anyway, or where a cluster's miss ratio stays within
+// threshold of the whole, and draws the clusters facing away from the centre of the mesh first, since they are the
+// likeliest to occlude the others
+void optimizeOverdraw(std::span<Index> indices, std::span<const math::Vector<3>> positions, float threshold = 1.05f);
+
+// vertex i of the result is vertex remap[i] of the input
+std::vector<Index> vertexFetchRemap(std::span<Index> indices, Size vertexCount);
+
+// renumbers the vertices in the order the indices first use them, the unused ones last
+template<typename Vertex>
+void optimizeVertexFetch(std::span<Index> indices, std::span<Vertex> vertices)
+{
+    const auto          remap = vertexFetchRemap(indices, vertices.size());
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+    for (const auto source : remap)
+    {
+        reordered.push_back(vertices[source]);
+    }
+    std::copy(reordered.begin(), reordered.end(), vertices.begin());
+}
+
+namespace detail
+{
+
+// Forsyth's scoring
+struct VertexScore
+{
+    static constexpr Size  cacheSize { 32 };
+    static constexpr float cacheDecayPower { 1.5f };
+    static constexpr float lastTriangleScore { 0.75f };
+    static constexpr float valenceBoostScale { 2.0f };
+    static constexpr float valenceBoostPower { 0.5f };
+
+    static float score(const int cachePosition, const UInt32 remainingTriangles)
+    {
+        if (remainingTriangles == 0)
+        {
+            return -1.0f;
+        }
+
+        float score { 0.0f };
+        if (cachePosition >= 0)
+        {
+            // the triangle just emitted is cheap wherever it goes, so its vertices all score the same
+            score = cachePosition < 3 ? lastTriangleScore :
+                                        std::pow(1.0f - static_cast<float>(cachePosition - 3) / (cacheSize - 3),
+                                                 cacheDecayPower);
+        }
+        // vertices with few triangles left are best finished off, before they fall out of the cache
+        return score + valenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -valenceBoostPower);
+    }
+};
+
+}  // namespace detail
+
+inline void optimizeVertexCache(const std::span<Index> indices, const Size vertexCount)
+{
+    using detail::VertexScore;
+    assert(indices.size() % 3 == 0);
+
+    const auto triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    // triangles of each vertex, compressed
+    std::vector<UInt32> remaining(vertexCount, 0);
+    for (const auto index : indices)
+    {
+        assert(index < vertexCount);
+        ++remaining[index];
+    }
+    std::vector<Size> firstTriangle(vertexCount + 1, 0);
+    std::partial_sum(remaining.begin(), remaining.end(), firstTriangle.begin() + 1);
+    std::vector<UInt32> adjacency(indices.size());
+    {
+        std::vector<Size> filled(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (Size i = 0; i < indices.size(); ++i)
+        {
+            adjacency[filled[indices[i]]++] = static_cast<UInt32>(i / 3);
+        }
+    }
+
+    std::vector<int>   cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (Size v = 0; v < vertexCount; ++v)
+    {
+        vertexScore[v] = VertexScore::score(-1, remaining[v]);
+    }
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool>  emitted(triangleCount, false);
+    for (Size t = 0; t < triangleCount; ++t)
+    {
+        triangleScore[t] =
+            vertexScore[indices[3 * t]] + vertexScore[indices[3 * t + 1]] + vertexScore[indices[3 * t + 2]];
+    }
+
+    // the emitted triangle's vertices, pushed in front of the cache, may overflow it by three before eviction
+    std::vector<Index> cache;
+    std::vector<Index> nextCache;
+    cache.reserve(VertexScore::cacheSize + 3);
+    nextCache.reserve(VertexScore::cacheSize + 3);
+
+    std::vector<Index> output;
+    output.reserve(indices.size());
+    Size scan { 0 };  // no triangle before it is left
+    auto best = static_cast<Size>(std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin());
+    while (true)
+    {
+        emitted[best] = true;
+        const std::array<Index, 3> triangle { indices[3 * best], indices[3 * best + 1], indices[3 * best + 2] };
+        output.insert(output.end(), triangle.begin(), triangle.end());
+
+        nextCache.assign(triangle.begin(), triangle.end());
+        for (const auto v : cache)
+        {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+            {
+                nextCache.push_back(v);
+            }
+        }
+        for (const auto v : triangle)
+        {
+            --remaining[v];
+            // the emitted triangle goes to the back of the vertex's list, out of the remaining ones
+            const auto begin = adjacency.begin() + static_cast<std::ptrdiff_t>(firstTriangle[v]);
+            const auto end   = begin + remaining[v] + 1;
+            std::iter_swap(std::find(begin, end, static_cast<UInt32>(best)), end - 1);
+        }
+
+        // new scores of the vertices whose cache position changed, and of their triangles
+        for (Size i = 0; i < nextCache.size(); ++i)
+        {
+            const auto v     = nextCache[i];
+            cachePosition[v] = i < VertexScore::cacheSize ? static_cast<int>(i) : -1;
+            vertexScore[v]   = VertexScore::score(cachePosition[v], remaining[v]);
+        }
+        float bestScore { -1.0f };
+        for (const auto v : nextCache)
+        {
+            for (Size a = firstTriangle[v]; a < firstTriangle[v] + remaining[v]; ++a)
+            {
+                const auto t     = adjacency[a];
+                triangleScore[t] = vertexScore[indices[3 * t]] + vertexScore[indices[3 * t + 1]] +
+                                   vertexScore[indices[3 * t + 2]];
+                if (triangleScore[t] > bestScore)
+                {
+                    bestScore = triangleScore[t];
+                    best      = t;
+                }
+            }
+        }
+        if (nextCache.size() > VertexScore::cacheSize)
+        {
+            nextCache.resize(VertexScore::cacheSize);
+        }
+        std::swap(cache, nextCache);
+
+        if (bestScore < 0)
+        {
+            // nothing left around the cache: restart from the first triangle left
+            while (scan < triangleCount && emitted[scan])
+            {
+                ++scan;
+            }
+            if (scan == triangleCount)
+            {
+                break;
+            }
+            best = scan;
+        }
+    }
+
+    assert(output.size() == indices.size());
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+inline void optimizeOverdraw(const std::span<Index> indices, const std::span<const math::Vector<3>> positions,
+                             const float threshold)
+{
+    assert(indices.size() % 3 == 0);
+
+    const auto triangleCount = indices.size() / 3;
+    if (triangleCount < 2)
+    {
+        return;
+    }
+
+    // hard boundaries: the triangles whose three vertices miss the cache, which restart it whatever comes before
+    constexpr Size    cacheSize { 16 };
+    std::vector<Size> cached(positions.size(), 0);
+    Size              time { cacheSize + 1 };
+    std::vector<Size> misses(triangleCount);
+    std::vector<Size> hard;
+    for (Size t = 0; t < triangleCount; ++t)
+    {
+        misses[t] = 0;
+        for (Size k = 0; k < 3; ++k)
+        {
+            const auto v = indices[3 * t + k];
+            if (time - cached[v] > cacheSize)
+            {
+                cached[v] = time++;
+                ++misses[t];
+            }
+        }
+        if (t == 0 || misses[t] == 3)
+        {
+            hard.push_back(t);
+        }
+    }
+    hard.push_back(triangleCount);
+
+    // soft boundaries: within a hard cluster, as soon as the part since the last boundary, drawn from a cold cache,
+    // misses within threshold of the cluster's ratio; moving the part elsewhere then costs little
+    std::vector<Size> clusters;
+    for (Size h = 0; h + 1 < hard.size(); ++h)
+    {
+        const auto begin         = hard[h];
+        const auto end           = hard[h + 1];
+        const auto clusterMisses = std::accumulate(misses.begin() + static_cast<std::ptrdiff_t>(begin),
+                                                   misses.begin() + static_cast<std::ptrdiff_t>(end), Size { 0 });
+        const auto clusterAcmr   = static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+        clusters.push_back(begin);
+        time += cacheSize + 1;  // empties the cache
+        Size partMisses { 0 };
+        for (Size t = begin; t < end; ++t)
+        {
+            for (Size k = 0; k < 3; ++k)
+            {
+                const auto v = indices[3 * t + k];
+                if (time - cached[v] > cacheSize)
+                {
+                    cached[v] = time++;
+                    ++partMisses;
+                }
+            }
+            const auto part = t + 1 - clusters.back();
+            if (t + 1 < end && static_cast<float>(partMisses) <= threshold * clusterAcmr * static_cast<float>(part))
+            {
+                clusters.push_back(t + 1);
+                time += cacheSize + 1;
+                partMisses = 0;
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // area weighted centroid and normal of the clusters, and of the mesh
+    const auto centroidAndNormal = [&](const Size begin, const Size end)
+    {
+        std::array<float, 3> centroid {};
+        std::array<float, 3> normal {};
+        float                area { 0 };
+        for (Size t = begin; t < end; ++t)
+        {
+            const auto& a = positions[indices[3 * t]];
+            const auto& b = positions[indices[3 * t + 1]];
+            const auto& c = positions[indices[3 * t + 2]];
+            const std::array<float, 3> u { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+            const std::array<float, 3> w { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+            const std::array<float, 3> n { u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2],
+                                           u[0] * w[1] - u[1] * w[0] };
+            const auto                 twiceArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (Size i = 0; i < 3; ++i)
+            {
+                centroid[i] += twiceArea * (a[i] + b[i] + c[i]) / 3;
+                normal[i] += n[i];
+            }
+            area += twiceArea;
+        }
+        if (area > 0)
+        {
+            for (auto& x : centroid)
+            {
+                x /= area;
+            }
+        }
+        if (const auto length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            length > 0)
+        {
+            for (auto& x : normal)
+            {
+                x /= length;
+            }
+        }
+        return std::pair { centroid, normal };
+    };
+
+    const auto meshCentroid = centroidAndNormal(0, triangleCount).first;
+    std::vector<std::pair<float, Size>> order;  // sort key and cluster
+    order.reserve(clusters.size() - 1);
+    for (Size i = 0; i + 1 < clusters.size(); ++i)
+    {
+        const auto [centroid, normal] = centroidAndNormal(clusters[i], clusters[i + 1]);
+        float key { 0 };
+        for (Size k = 0; k < 3; ++k)
+        {
+            key += (centroid[k] - meshCentroid[k]) * normal[k];
+        }
+        order.emplace_back(-key, i);
+    }
+    std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<Index> output;
+    output.reserve(indices.size());
+    for (const auto& [key, cluster] : order)
+    {
+        output.insert(output.end(), indices.begin() + static_cast<std::ptrdiff_t>(3 * clusters[cluster]),
+                      indices.begin() + static_cast<std::ptrdiff_t>(3 * clusters[cluster + 1]));
+    }
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+inline std::vector<Index> vertexFetchRemap(const std::span<Index> indices, const Size vertexCount)
+{
+    constexpr auto     unused = std::numeric_limits<Index>::max();
+    std::vector<Index> target(vertexCount, unused);  // new position of each vertex
+    std::vector<Index> remap;
+    remap.reserve(vertexCount);
+    for (auto& index : indices)
+    {
+        assert(index < vertexCount);
+        if (target[index] == unused)
+        {
+            target[index] = static_cast<Index>(remap.size());
+            remap.push_back(index);
+        }
+        index = target[index];
+    }
+    for (Size v = 0; v < vertexCount; ++v)
+    {
+        if (target[v] == unused)
+        {
+            remap.push_back(static_cast<Index>(v));
+        }
+    }
+    return remap;
+}
+
+}  // namespace surge::geometry
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "surge/types.hpp"
+#include "surge/math/Vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// conversions of float attributes to the compact formats the vertex input decodes: normalized integers, half floats
+// and octahedral unit vectors. Encodings round to nearest
+namespace surge::geometry
+{
+
+UInt8  quantizeUnorm8(float value);
+UInt16 quantizeUnorm16(float value);
+Int16  quantizeSnorm16(float value);
+
+// binary16 with round to nearest even; out of range values become infinities
+UInt16 quantizeHalf(float value);
+
+std::array<UInt8, 4> quantizeUnorm8(const math::Vector<4>& value);
+
+// the weights still sum to one once normalized, the rounding error going to the largest
+std::array<UInt16, 4> quantizeWeights(const math::Vector<4>& weights);
+
+// Cigolle et al., A Survey of Efficient Representations for Independent Unit Vectors: the direction projected on the
+// octahedron, whose lower half is folded over the upper, as two snorm16. The zero vector maps to +z
+std::array<Int16, 2> encodeOctahedral(const math::Vector<3>& direction);
+math::Vector<3>      decodeOctahedral(const std::array<Int16, 2>& encoded);
+
+inline UInt8 quantizeUnorm8(const float value)
+{
+    return static_cast<UInt8>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+inline UInt16 quantizeUnorm16(const float value)
+{
+    return static_cast<UInt16>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+inline Int16 quantizeSnorm16(const float value)
+{
+    return static_cast<Int16>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+inline UInt16 quantizeHalf(const float value)
+{
+    const auto bits     = std::bit_cast<std::uint32_t>(value);
+    const auto sign     = static_cast<std::uint32_t>((bits >> 16) & 0x8000);
+    const auto exponent = static_cast<std::int32_t>((bits >> 23) & 0xff) - 127 + 15;
+    auto       mantissa = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff)
+    {
+        // infinities and nans, which keep a mantissa bit
+        return static_cast<UInt16>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+    }
+    if (exponent >= 31)
+    {
+        return static_cast<UInt16>(sign | 0x7c00);
+    }
+    if (exponent <= 0)
+    {
+        // subnormal, or zero below half the smallest one
+        if (exponent < -10)
+        {
+            return static_cast<UInt16>(sign);
+        }
+        mantissa |= 0x800000;
+        const auto shift = static_cast<std::uint32_t>(14 - exponent);
+        auto       half  = mantissa >> shift;
+        const auto rest  = mantissa & ((1u << shift) - 1);
+        const auto tie   = 1u << (shift - 1);
+        if (rest > tie || (rest == tie && (half & 1) != 0))
+        {
+            ++half;
+        }
+        return static_cast<UInt16>(sign | half);
+    }
+
+    // a carry out of the mantissa rounds up the exponent, up to infinity
+    auto       half = (static_cast<std::uint32_t>(exponent) << 10) | (mantissa >> 13);
+    const auto rest = mantissa & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1) != 0))
+    {
+        ++half;
+    }
+    return static_cast<UInt16>(sign | half);
+}
+
+inline std::array<UInt8, 4> quantizeUnorm8(const math::Vector<4>& value)
+{
+    return { quantizeUnorm8(value[0]), quantizeUnorm8(value[1]), quantizeUnorm8(value[2]), quantizeUnorm8(value[3]) };
+}
+
+inline std::array<UInt16, 4> quantizeWeights(const math::Vector<4>& weights)
+{
+    const auto sum = weights[0] + weights[1] + weights[2] + weights[3];
+    if (sum <= 0)
+    {
+        return { 0, 0, 0, 0 };
+    }
+
+    std::array<UInt16, 4> quantized;
+    std::int32_t          total { 0 };
+    for (Size i = 0; i < 4; ++i)
+    {
+        quantized[i] = quantizeUnorm16(weights[i] / sum);
+        total += quantized[i];
+    }
+    auto& largest = *std::max_element(quantized.begin(), quantized.end());
+    largest       = static_cast<UInt16>(largest + 65535 - total);
+    return quantized;
+}
+
+inline std::array<Int16, 2> encodeOctahedral(const math::Vector<3>& direction)
+{
+    const auto norm = std::abs(direction[0]) + std::abs(direction[1]) + std::abs(direction[2]);
+    if (norm == 0)
+    {
+        return { 0, 0 };
+    }
+
+    auto       x           = direction[0] / norm;
+    auto       y           = direction[1] / norm;
+    const auto signNotZero = [](const float value) { return value >= 0 ? 1.0f : -1.0f; };
+    if (direction[2] < 0)
+    {
+        const auto folded = std::array { (1 - std::abs(y)) * signNotZero(x), (1 - std::abs(x)) * signNotZero(y) };
+        x                 = folded[0];
+        y                 = folded[1];
+    }
+    return { quantizeSnorm16(x), quantizeSnorm16(y) };
+}
+
+inline math::Vector<3> decodeOctahedral(const std::array<Int16, 2>& encoded)
+{
+    const auto x = std::max(static_cast<float>(encoded[0]) / 32767.0f, -1.0f);
+    const auto y = std::max(static_cast<float>(encoded[1]) / 32767.0f, -1.0f);
+
+    math::Vector<3> direction { x, y, 1 - std::abs(x) - std::abs(y) };
+    const auto      fold = std::max(-direction[2], 0.0f);
+    direction[0] += direction[0] >= 0 ? -fold : fold;
+    direction[1] += direction[1] >= 0 ? -fold : fold;
+
+    const auto length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] +
+                                  direction[2] * direction[2]);
+    return { direction[0] / length, direction[1] / length, direction[2] / length };
+}
+
+}  // namespace surge::geometry
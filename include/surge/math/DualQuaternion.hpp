@@ -0,0 +1,67 @@
+#pragma once
+
+#include "surge/math/angles.hpp"
+#include "surge/math/Matrix.hpp"
+
+#include <cmath>
+
+namespace surge::math
+{
+
+// rigid transform, rotation r and translation t as r + eps * (t r) / 2; (x, y, z, w) storage for both parts
+template<typename Type = float>
+struct DualQuaternion
+{
+    Quaternion<Type> real;
+    Quaternion<Type> dual;
+};
+
+// rotation of the upper 3x3 block, columns are normalized so that scale does not leak into the rotation
+template<typename Type>
+Quaternion<Type> toQuaternion(const Matrix<4, 4, Type>& m)
+{
+    const Vector<3, Type> scale {
+        std::hypot(get<0, 0>(m), get<1, 0>(m), get<2, 0>(m)),
+        std::hypot(get<0, 1>(m), get<1, 1>(m), get<2, 1>(m)),
+        std::hypot(get<0, 2>(m), get<1, 2>(m), get<2, 2>(m)),
+    };
+    const auto r = [&](const Size row, const Size col) { return m[4 * row + col] / scale[col]; };
+
+    constexpr Type   one { 1 };
+    constexpr Type   half { 0.5 };
+    const auto       trace = r(0, 0) + r(1, 1) + r(2, 2);
+    Quaternion<Type> q;
+    if (trace > 0)
+    {
+        const auto s = half / std::sqrt(trace + one);
+        q            = { (r(2, 1) - r(1, 2)) * s, (r(0, 2) - r(2, 0)) * s, (r(1, 0) - r(0, 1)) * s, Type { 0.25 } / s };
+    }
+    else if (r(0, 0) > r(1, 1) && r(0, 0) > r(2, 2))
+    {
+        const auto s = 2 * std::sqrt(one + r(0, 0) - r(1, 1) - r(2, 2));
+        q            = { s / 4, (r(0, 1) + r(1, 0)) / s, (r(0, 2) + r(2, 0)) / s, (r(2, 1) - r(1, 2)) / s };
+    }
+    else if (r(1, 1) > r(2, 2))
+    {
+        const auto s = 2 * std::sqrt(one + r(1, 1) - r(0, 0) - r(2, 2));
+        q            = { (r(0, 1) + r(1, 0)) / s, s / 4, (r(1, 2) + r(2, 1)) / s, (r(0, 2) - r(2, 0)) / s };
+    }
+    else
+    {
+        const auto s = 2 * std::sqrt(one + r(2, 2) - r(0, 0) - r(1, 1));
+        q            = { (r(0, 2) + r(2, 0)) / s, (r(1, 2) + r(2, 1)) / s, s / 4, (r(1, 0) - r(0, 1)) / s };
+    }
+    return normalize(q);
+}
+
+// of a transform acting on column vectors; scale and shear are dropped
+template<typename Type>
+DualQuaternion<Type> toDualQuaternion(const Matrix<4, 4, Type>& m)
+{
+    constexpr Type         half { 0.5 };
+    const auto             real = toQuaternion(m);
+    const Quaternion<Type> halfTranslation { half * get<0, 3>(m), half * get<1, 3>(m), half * get<2, 3>(m), 0 };
+    return { real, multiply(halfTranslation, real) };
+}
+
+}  // namespace surge::math
@@ -2,12 +2,15 @@
 
 #include "surge/utils.hpp"
 #include "surge/math/Vector.hpp"
+#include "surge/math/simd.hpp"
 
 #include "glm/glm.hpp"
 
+#include <bit>
 #include <concepts>
 #include <format>
 #include <cstring>
+#include <type_traits>
 
 namespace surge::math
 {
@@ -116,6 +119,129 @@ constexpr auto get(const glm::mat4& m)
     // return m[row][col];
 }
 
+// implementation: Sparse
+// the entries of a matrix that can be nonzero, bit row * c + col of mask, stored in row major order; zero patterns
+// known at compile time carry over products of structured matrices this way, instead of being lost to a dense result
+template<Size r, Size c, UInt64 mask, typename T = Float32>
+    requires(r * c <= 64)
+class Sparse : public std::array<T, std::popcount(mask)>
+{
+public:
+    operator Matrix<r, c, T>() const
+    {
+        return fullMatrix(*this);
+    }
+};
+
+template<Size r, Size c, UInt64 mask, typename T>
+constexpr Size rows<Sparse<r, c, mask, T>> = r;
+
+template<Size r, Size c, UInt64 mask, typename T>
+constexpr Size cols<Sparse<r, c, mask, T>> = c;
+
+template<Size row, Size col, Size r, Size c, UInt64 mask, typename T>
+constexpr bool nonzero<row, col, Sparse<r, c, mask, T>> = (mask >> (row * c + col)) & 1;
+
+// position of the entry among the stored ones
+template<Size row, Size col, Size c, UInt64 mask>
+consteval Size sparseIndex()
+{
+    return std::popcount(mask & ((UInt64 { 1 } << (row * c + col)) - 1));
+}
+
+template<Size row, Size col, Size r, Size c, UInt64 mask, typename T>
+    requires ValidIndices<row, col, Sparse<r, c, mask, T>>
+constexpr auto& get(const Sparse<r, c, mask, T>& m)
+{
+    if constexpr (nonzero<row, col, Sparse<r, c, mask, T>>)
+    {
+        return m[sparseIndex<row, col, c, mask>()];
+    }
+    else
+    {
+        return zero<T>;
+    }
+}
+
+template<Size row, Size col, Size r, Size c, UInt64 mask, typename T>
+    requires ValidIndices<row, col, Sparse<r, c, mask, T>> && nonzero<row, col, Sparse<r, c, mask, T>>
+constexpr auto& get(Sparse<r, c, mask, T>& m)
+{
+    return m[sparseIndex<row, col, c, mask>()];
+}
+
+// entries of a b that can be nonzero, as a Sparse mask
+template<StaticMatrix A, StaticMatrix B>
+    requires(rows<A> * cols<B> <= 64)
+constexpr UInt64 productMask = []
+{
+    UInt64 mask {};
+    forEach<0, rows<A>, 0, cols<B>, 0, cols<A>>(
+        [&]<Size row, Size col, Size mid>()
+        {
+            if constexpr (nonzero<row, mid, A> && nonzero<mid, col, B>)
+            {
+                mask |= UInt64 { 1 } << (row * cols<B> + col);
+            }
+        });
+    return mask;
+}();
+
+// multiplications a b costs, the products by known zeros being left out
+template<StaticMatrix A, StaticMatrix B>
+constexpr Size productCost = []
+{
+    Size cost {};
+    forEach<0, rows<A>, 0, cols<B>, 0, cols<A>>(
+        [&]<Size row, Size col, Size mid>()
+        {
+            if constexpr (nonzero<row, mid, A> && nonzero<mid, col, B>)
+            {
+                ++cost;
+            }
+        });
+    return cost;
+}();
+
+// whether a[row][mid] b[mid][col] is the first term of the entry of a b that can be nonzero; assigned rather than
+// added to 0, which the compiler may not fold away for floats
+template<Size row, Size col, Size mid, typename A, typename B>
+constexpr bool firstTerm = []
+{
+    bool first { nonzero<row, mid, A> && nonzero<mid, col, B> };
+    forEach<0, mid>(
+        [&]<Size previous>()
+        {
+            if constexpr (nonzero<row, previous, A> && nonzero<previous, col, B>)
+            {
+                first = false;
+            }
+        });
+    return first;
+}();
+
+template<StaticMatrix A, StaticMatrix B>
+consteval auto productType()
+{
+    using T = ValueType<A>;
+    if constexpr (rows<A> * cols<B> > 64)
+    {
+        return std::type_identity<Matrix<rows<A>, cols<B>, T>> {};
+    }
+    else if constexpr (static_cast<Size>(std::popcount(productMask<A, B>)) < rows<A> * cols<B>)
+    {
+        return std::type_identity<Sparse<rows<A>, cols<B>, productMask<A, B>, T>> {};
+    }
+    else
+    {
+        return std::type_identity<Matrix<rows<A>, cols<B>, T>> {};
+    }
+}
+
+// Sparse while a b has known zeros, dense otherwise
+template<StaticMatrix A, StaticMatrix B>
+using Product = typename decltype(productType<A, B>())::type;
+
 // operations
 template<StaticMatrix M>
 Matrix<rows<M>, cols<M>, ValueType<M>> fullMatrix(const M& matrix)
@@ -176,15 +302,21 @@ constexpr bool operator!=(const A& a, const B& b)
 }
 
 
+// a Sparse that keeps the known zeros of a b when there are any, a dense Matrix otherwise: products of sparse
+// operands are not Matrix, fullMatrix converts them
 template<StaticMatrix A, StaticMatrix B>
     requires HasSizes<A> && HasSizes<B> && (cols<A> == rows<B>)
-constexpr Matrix<rows<A>, cols<B>, ValueType<A>> operator*(const A& a, const B& b)
+constexpr Product<A, B> operator*(const A& a, const B& b)
 {
-    Matrix<rows<A>, cols<B>, ValueType<A>> c {};
+    Product<A, B> c {};
     forEach<0, rows<A>, 0, cols<B>, 0, cols<A>>(
         [&]<Size row, Size col, Size mid>()
         {
-            if constexpr (nonzero<row, mid, A> && nonzero<mid, col, B>)
+            if constexpr (firstTerm<row, col, mid, A, B>)
+            {
+                get<row, col>(c) = get<row, mid>(a) * get<mid, col>(b);
+            }
+            else if constexpr (nonzero<row, mid, A> && nonzero<mid, col, B>)
             {
                 get<row, col>(c) += get<row, mid>(a) * get<mid, col>(b);
             }
@@ -192,6 +324,21 @@ constexpr Matrix<rows<A>, cols<B>, ValueType<A>> operator*(const A& a, const B&
     return c;
 }
 
+// the common shape goes through the simd backend, outside of constant evaluation
+constexpr Matrix<4, 4> operator*(const Matrix<4, 4>& a, const Matrix<4, 4>& b)
+{
+    if consteval
+    {
+        return operator*<Matrix<4, 4>, Matrix<4, 4>>(a, b);
+    }
+    else
+    {
+        Matrix<4, 4> c;
+        simd::multiply(a.data(), b.data(), c.data());
+        return c;
+    }
+}
+
 
 template<StaticMatrix M>
 constexpr M operator*(const M& m, const ValueType<M>& a)
@@ -311,6 +458,13 @@ Matrix<rows<M>, cols<M>, ValueType<M>> inverse(const M& m)
     return det != ValueType<M> { 0 } ? inv / det : throw std::runtime_error("Singular matrix");
 }
 
+Matrix<4, 4> inverse(const Matrix<4, 4>& m);
+Matrix<4, 4> inverse(const Matrix<4, 4>& m)
+{
+    Matrix<4, 4> inv;
+    return simd::inverse(m.data(), inv.data()) != 0 ? inv : throw std::runtime_error("Singular matrix");
+}
+
 std::string toString(const float* const p, const int rows, const int cols);
 std::string toString(const float* const p, const int rows, const int cols)
 {
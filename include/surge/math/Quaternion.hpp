@@ -0,0 +1,252 @@
+#pragma once
+
+#include "surge/math/Matrix.hpp"
+#include "surge/math/Vector.hpp"
+#include "surge/math/simd.hpp"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+namespace surge::math
+{
+
+// rotation x i + y j + z k + w, stored (x, y, z, w) like glTF and the shaders; blends still go through the component
+// wise operations of Vector<4>, the product is the Hamilton one
+template<typename T = float>
+class Quaternion : public Vector<4, T>
+{
+public:
+    constexpr Quaternion()
+        : Vector<4, T> {}
+    {
+    }
+
+    constexpr Quaternion(const T x, const T y, const T z, const T w)
+        : Vector<4, T> { x, y, z, w }
+    {
+    }
+
+    // from the results of vector operations
+    constexpr Quaternion(const Vector<4, T>& v)
+        : Vector<4, T> { v }
+    {
+    }
+};
+
+template<typename T>
+constexpr Size length<Quaternion<T>> = 4;
+
+}  // namespace surge::math
+
+template<typename T>
+struct std::tuple_size<surge::math::Quaternion<T>> : std::integral_constant<std::size_t, 4>
+{
+};
+
+template<std::size_t index, typename T>
+struct std::tuple_element<index, surge::math::Quaternion<T>>
+{
+    using type = T;
+};
+
+namespace surge::math
+{
+
+// the simd paths of Vector<4>
+constexpr float dot(const Quaternion<>& a, const Quaternion<>& b)
+{
+    return dot(static_cast<const Vector<4>&>(a), static_cast<const Vector<4>&>(b));
+}
+
+constexpr Quaternion<> normalize(const Quaternion<>& q)
+{
+    return normalize(static_cast<const Vector<4>&>(q));
+}
+
+template<typename Type>
+constexpr Quaternion<Type> conjugate(const Quaternion<Type>& q)
+{
+    return { -get<0>(q), -get<1>(q), -get<2>(q), get<3>(q) };
+}
+
+// Hamilton product: the rotation by b, then by a
+template<typename Type>
+constexpr Quaternion<Type> multiply(const Quaternion<Type>& a, const Quaternion<Type>& b)
+{
+    const auto [ax, ay, az, aw] = a;
+    const auto [bx, by, bz, bw] = b;
+    return {
+        aw * bx + ax * bw + ay * bz - az * by,
+        aw * by - ax * bz + ay * bw + az * bx,
+        aw * bz + ax * by - ay * bx + az * bw,
+        aw * bw - ax * bx - ay * by - az * bz,
+    };
+}
+
+template<typename Type>
+constexpr Quaternion<Type> operator*(const Quaternion<Type>& a, const Quaternion<Type>& b)
+{
+    return multiply(a, b);
+}
+
+// of a unit quaternion, acting on column vectors
+template<typename Type>
+constexpr Matrix<3, 3, Type> toMatrix(const Quaternion<Type>& q)
+{
+    const auto [x, y, z, w] = q;
+    const auto     xx { x * x };
+    const auto     yy { y * y };
+    const auto     zz { z * z };
+    const auto     xz { x * z };
+    const auto     xy { x * y };
+    const auto     yz { y * z };
+    const auto     wx { w * x };
+    const auto     wy { w * y };
+    const auto     wz { w * z };
+    constexpr Type one { 1 };
+    constexpr Type two { 2 };
+    return Matrix<3, 3, Type> {
+        one - two * (yy + zz), two * (xy - wz),       two * (xz + wy),        //
+        two * (xy + wz),       one - two * (xx + zz), two * (yz - wx),        //
+        two * (xz - wy),       two * (yz + wx),       one - two * (xx + yy),  //
+    };
+}
+
+// wx x + wy y
+template<typename Type>
+constexpr Quaternion<Type> combine(const Quaternion<Type>& x, const Type wx, const Quaternion<Type>& y, const Type wy)
+{
+    Quaternion<Type> q;
+    forEach<0, 4>([&]<Size i>() { q[i] = wx * x[i] + wy * y[i]; });
+    return q;
+}
+
+// the reference, with trigonometry
+template<typename Type>
+Quaternion<Type> slerp(const Quaternion<Type>& x, const Quaternion<Type>& y, Type a)
+{
+    constexpr Type one { 1 };
+
+    // the short way around the sphere
+    Type       cosTheta = dot(x, y);
+    const Type sign     = cosTheta < 0 ? -one : one;
+    cosTheta *= sign;
+
+    // sin(angle) vanishes as the quaternions get close
+    if (cosTheta > one - std::numeric_limits<Type>::epsilon())
+    {
+        return combine(x, one - a, y, sign * a);
+    }
+
+    // Essential Mathematics, page 467
+    const Type angle    = std::acos(cosTheta);
+    const Type sinAngle = std::sin(angle);
+    return combine(x, std::sin((one - a) * angle) / sinAngle, y, sign * std::sin(a * angle) / sinAngle);
+}
+
+// normalized lerp on the short arc; no trigonometry but a varying angular speed: between keys 30 degrees of rotation
+// apart it strays at most 0.03 degrees from slerp, 0.3 degrees at 60, 2.2 degrees at 120
+template<typename Type>
+Quaternion<Type> nlerp(const Quaternion<Type>& x, const Quaternion<Type>& y, const Type a)
+{
+    return normalize(combine(x, 1 - a, y, dot(x, y) < 0 ? -a : a));
+}
+
+// sin(t theta) / sin(theta) as a series in cos(theta) - 1, truncated to 8 terms whose last one is scaled to spread the
+// truncation error (Eberly, A Fast and Accurate Algorithm for Computing SLERP): within 2e-5 for any angle between
+// the quaternions, within 1e-6 up to 60 degrees, that is 120 degrees of rotation
+struct SlerpSeries
+{
+    static constexpr Size  terms { 8 };
+    static constexpr float mu { 1.85298109240830f };
+
+    // term i is (u[i] t^2 - v[i]) (cos(theta) - 1)
+    static constexpr auto u = []
+    {
+        std::array<float, terms> u;
+        for (Size i = 1; i <= terms; ++i)
+        {
+            u[i - 1] = (i == terms ? mu : 1.0f) / (i * (2.0f * i + 1));
+        }
+        return u;
+    }();
+    static constexpr auto v = []
+    {
+        std::array<float, terms> v;
+        for (Size i = 1; i <= terms; ++i)
+        {
+            v[i - 1] = (i == terms ? mu : 1.0f) * i / (2.0f * i + 1);
+        }
+        return v;
+    }();
+
+    template<typename Type>
+    static constexpr Type weight(const Type t, const Type cosine)
+    {
+        const auto c = cosine - 1;
+        Type       s { 1 };
+        for (Size i = terms; i-- > 0;)
+        {
+            s = 1 + (u[i] * t * t - v[i]) * c * s;
+        }
+        return t * s;
+    }
+
+    static simd::Float4 weight(const simd::Float4 t, const simd::Float4 cosine)
+    {
+        const auto one = simd::broadcast(1);
+        const auto tt  = simd::mul(t, t);
+        const auto c   = simd::sub(cosine, one);
+        auto       s   = one;
+        for (Size i = terms; i-- > 0;)
+        {
+            const auto term = simd::mul(simd::sub(simd::mul(simd::broadcast(u[i]), tt), simd::broadcast(v[i])), c);
+            s               = simd::madd(term, s, one);
+        }
+        return simd::mul(t, s);
+    }
+};
+
+// (wx, wy) with slerp(x, y, t) = wx x + wy y on the short arc, from the cosine of the angle between x and y; wy
+// applies to -y when the cosine is negative
+template<typename Type>
+constexpr Vector<2, Type> slerpWeights(const Type cosine, const Type t)
+{
+    const auto c = std::abs(cosine);
+    return { SlerpSeries::weight(1 - t, c), SlerpSeries::weight(t, c) };
+}
+
+// slerpWeights of n pairs, four per simd step
+void slerpWeights(const float* cosines, const float* t, float* wx, float* wy, Size n);
+
+inline void slerpWeights(const float* cosines, const float* t, float* wx, float* wy, const Size n)
+{
+    const auto one = simd::broadcast(1);
+    Size       i   = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const auto c = simd::abs(simd::load(cosines + i));
+        const auto a = simd::load(t + i);
+        simd::store(wx + i, SlerpSeries::weight(simd::sub(one, a), c));
+        simd::store(wy + i, SlerpSeries::weight(a, c));
+    }
+    for (; i < n; ++i)
+    {
+        const auto [x, y] = slerpWeights(cosines[i], t[i]);
+        wx[i]             = x;
+        wy[i]             = y;
+    }
+}
+
+// slerp without trigonometry
+template<typename Type>
+Quaternion<Type> fastSlerp(const Quaternion<Type>& x, const Quaternion<Type>& y, const Type a)
+{
+    const auto cosine   = dot(x, y);
+    const auto [wx, wy] = slerpWeights(cosine, a);
+    return combine(x, wx, y, cosine < 0 ? -wy : wy);
+}
+
+}  // namespace surge::math
@@ -3,6 +3,7 @@
 #include "surge/utils.hpp"
 #include "surge/types.hpp"
 #include "surge/math/math.hpp"
+#include "surge/math/simd.hpp"
 
 #include <array>
 #include <cassert>
@@ -113,7 +114,7 @@ constexpr surge::math::Vector<size, Type> operator*(const surge::math::Vector<si
 {
     surge::math::Vector<size, Type> c;
     surge::forEach<0, size>([&]<int i>() { c[i] = a[i] * b[i]; });
-    return b;
+    return c;
 }
 
 template<surge::Size size, typename Type>
@@ -181,6 +182,33 @@ constexpr V normalize(const V& v)
     return v / n;
 }
 
+constexpr float dot(const Vector<4>& a, const Vector<4>& b)
+{
+    if consteval
+    {
+        return dot<Vector<4>>(a, b);
+    }
+    else
+    {
+        return simd::dot4(a.data(), b.data());
+    }
+}
+
+constexpr Vector<4> normalize(const Vector<4>& v)
+{
+    if consteval
+    {
+        return normalize<Vector<4>>(v);
+    }
+    else
+    {
+        assert(simd::dot4(v.data(), v.data()) > 0);
+        Vector<4> n;
+        simd::normalize4(v.data(), n.data());
+        return n;
+    }
+}
+
 template<surge::Size size, typename Type = surge::Float32>
 std::string toString(const surge::math::Vector<size, Type>& vec)
 {
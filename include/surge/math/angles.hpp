@@ -1,5 +1,6 @@
 #pragma once
 
+#include "surge/math/Quaternion.hpp"
 #include "surge/math/Vector.hpp"
 
 #include <numbers>
@@ -8,14 +9,6 @@
 namespace surge::math
 {
 
-template<typename Type = float>
-using Quaternion = Vector<4, Type>;
-// struct Quaternion
-// {
-//     double w, x, y, z;
-// };
-
-
 // roll, pitch, yaw
 enum class Angle
 {
@@ -107,38 +100,4 @@ constexpr EulerAngles<Angle::radians, Type> toEulerAngles(const Quaternion<Type>
     return Vector<3> { yaw(quaternion), pitch(quaternion), roll(quaternion) };
 }
 
-template<typename Type>
-constexpr Quaternion<Type> slerp(const Quaternion<Type>& x, const Quaternion<Type>& y, Type a)
-{
-    constexpr Type zero { 0 };
-    constexpr Type one { 1 };
-
-    Quaternion<Type> z { y };
-
-    Type cosTheta = dot(x, y);
-
-    // If cosTheta < 0, the interpolation will take the long way around the sphere.
-    // To fix this, one quat must be negated.
-    if (cosTheta < zero)
-    {
-        z        = -y;
-        cosTheta = -cosTheta;
-    }
-
-    // Perform a linear interpolation when cosTheta is close to 1 to avoid side effect of sin(angle) becoming a zero
-    // denominator
-    if (cosTheta > one - std::numeric_limits<Type>::epsilon())
-    {
-        // Linear interpolation
-        // return Quaternion<Type> { mix(x.w, z.w, a), mix(x.x, z.x, a), mix(x.y, z.y, a), mix(x.z, z.z, a) };
-        return lerp(x, z, a);
-    }
-    else
-    {
-        // Essential Mathematics, page 467
-        Type angle = std::acos(cosTheta);
-        return (std::sin((one - a) * angle) * x + std::sin(a * angle) * z) / std::sin(angle);
-    }
-}
-
 }  // namespace surge::math
\ No newline at end of file
@@ -0,0 +1,343 @@
+#pragma once
+
+#include "surge/math/BoundingBox.hpp"
+#include "surge/math/matrices.hpp"
+#include "surge/math/simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// kernels over many points, boxes or spheres at once; the elements are held as structures of arrays so that four of
+// them fill the lanes of a simd::Float4, the remainder of a batch goes through the same arithmetic in scalar code
+namespace surge::math::batch
+{
+
+// points or directions, one array per coordinate
+struct Points
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+
+    std::size_t size() const
+    {
+        return x.size();
+    }
+
+    void resize(const std::size_t size)
+    {
+        x.resize(size);
+        y.resize(size);
+        z.resize(size);
+    }
+
+    void push_back(const Vector<3>& p)
+    {
+        x.push_back(p[0]);
+        y.push_back(p[1]);
+        z.push_back(p[2]);
+    }
+
+    Vector<3> operator[](const std::size_t i) const
+    {
+        return { x[i], y[i], z[i] };
+    }
+};
+
+struct Boxes
+{
+    Points min;
+    Points max;
+
+    std::size_t size() const
+    {
+        return min.size();
+    }
+
+    void resize(const std::size_t size)
+    {
+        min.resize(size);
+        max.resize(size);
+    }
+
+    void push_back(const BoundingBox& box)
+    {
+        min.push_back(box.min);
+        max.push_back(box.max);
+    }
+
+    BoundingBox operator[](const std::size_t i) const
+    {
+        return { min[i], max[i] };
+    }
+};
+
+struct Spheres
+{
+    Points             center;
+    std::vector<float> radius;
+
+    std::size_t size() const
+    {
+        return radius.size();
+    }
+
+    void resize(const std::size_t size)
+    {
+        center.resize(size);
+        radius.resize(size);
+    }
+
+    void push_back(const Vector<3>& c, const float r)
+    {
+        center.push_back(c);
+        radius.push_back(r);
+    }
+};
+
+// points p with dot(normal, p) + distance >= 0 are inside
+struct Plane
+{
+    Vector<3> normal;
+    float     distance;
+};
+
+// left, right, bottom, top, near, far
+using Frustum = std::array<Plane, 6>;
+
+// planes of the clip volume of a projection with depth in [0, 1], in the space the matrix maps from; a view
+// projection gives world space planes
+Frustum frustum(const Matrix<4, 4>& m);
+
+// out = m p, out may be in
+void transformPoints(const Affine<>& m, const Points& in, Points& out);
+
+// unit normals of the transformed surface, by the inverse transpose of the linear part of m; out may be in
+void transformNormals(const Affine<>& m, const Points& in, Points& out);
+
+// out[i] = bounds of the box in[i] transformed by m[i]; out may be in
+void transformBoxes(const std::vector<Affine<>>& m, const Boxes& in, Boxes& out);
+
+// visible[i] = 0 when the sphere i lies entirely outside of a plane of the frustum, 1 otherwise; conservative near
+// the edges of the frustum
+void intersect(const Frustum& frustum, const Spheres& spheres, std::vector<uint8_t>& visible);
+
+// implementation
+
+inline Frustum frustum(const Matrix<4, 4>& m)
+{
+    // w * row 3 + sign * row of the clip coordinates
+    const auto plane = [&](const float w, const float sign, const Size row)
+    {
+        Vector<4> p;
+        for (Size col = 0; col < 4; ++col)
+        {
+            p[col] = w * m[12 + col] + sign * m[4 * row + col];
+        }
+        const auto length = std::hypot(p[0], p[1], p[2]);
+        return Plane { { p[0] / length, p[1] / length, p[2] / length }, p[3] / length };
+    };
+    // 0 <= z for the near plane, unlike the -w <= z of OpenGL
+    return { plane(1, 1, 0), plane(1, -1, 0), plane(1, 1, 1), plane(1, -1, 1), plane(0, 1, 2), plane(1, -1, 2) };
+}
+
+inline void transformPoints(const Affine<>& m, const Points& in, Points& out)
+{
+    const auto size = in.size();
+    out.resize(size);
+
+    simd::Float4 lanes[12];
+    for (Size i = 0; i < 12; ++i)
+    {
+        lanes[i] = simd::broadcast(m[i]);
+    }
+
+    Size i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        const auto x = simd::load(in.x.data() + i);
+        const auto y = simd::load(in.y.data() + i);
+        const auto z = simd::load(in.z.data() + i);
+        const auto row = [&](const Size r)
+        {
+            return simd::madd(lanes[4 * r], x,
+                              simd::madd(lanes[4 * r + 1], y, simd::madd(lanes[4 * r + 2], z, lanes[4 * r + 3])));
+        };
+        simd::store(out.x.data() + i, row(0));
+        simd::store(out.y.data() + i, row(1));
+        simd::store(out.z.data() + i, row(2));
+    }
+    for (; i < size; ++i)
+    {
+        const auto x = in.x[i];
+        const auto y = in.y[i];
+        const auto z = in.z[i];
+        out.x[i]     = m[0] * x + (m[1] * y + (m[2] * z + m[3]));
+        out.y[i]     = m[4] * x + (m[5] * y + (m[6] * z + m[7]));
+        out.z[i]     = m[8] * x + (m[9] * y + (m[10] * z + m[11]));
+    }
+}
+
+inline void transformNormals(const Affine<>& m, const Points& in, Points& out)
+{
+    const auto size = in.size();
+    out.resize(size);
+
+    // transposed linear part of the inverse
+    const auto                 inv = inverse(m);
+    const std::array<float, 9> n { inv[0], inv[4], inv[8], inv[1], inv[5], inv[9], inv[2], inv[6], inv[10] };
+    simd::Float4               lanes[9];
+    for (Size i = 0; i < 9; ++i)
+    {
+        lanes[i] = simd::broadcast(n[i]);
+    }
+
+    Size i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        const auto x       = simd::load(in.x.data() + i);
+        const auto y       = simd::load(in.y.data() + i);
+        const auto z       = simd::load(in.z.data() + i);
+        const auto nx      = simd::madd(lanes[0], x, simd::madd(lanes[1], y, simd::mul(lanes[2], z)));
+        const auto ny      = simd::madd(lanes[3], x, simd::madd(lanes[4], y, simd::mul(lanes[5], z)));
+        const auto nz      = simd::madd(lanes[6], x, simd::madd(lanes[7], y, simd::mul(lanes[8], z)));
+        const auto length2 = simd::madd(nx, nx, simd::madd(ny, ny, simd::mul(nz, nz)));
+        const auto scale   = simd::div(simd::broadcast(1), simd::sqrt(length2));
+        simd::store(out.x.data() + i, simd::mul(nx, scale));
+        simd::store(out.y.data() + i, simd::mul(ny, scale));
+        simd::store(out.z.data() + i, simd::mul(nz, scale));
+    }
+    for (; i < size; ++i)
+    {
+        const auto x     = in.x[i];
+        const auto y     = in.y[i];
+        const auto z     = in.z[i];
+        const auto nx    = n[0] * x + (n[1] * y + n[2] * z);
+        const auto ny    = n[3] * x + (n[4] * y + n[5] * z);
+        const auto nz    = n[6] * x + (n[7] * y + n[8] * z);
+        const auto scale = 1 / std::sqrt(nx * nx + (ny * ny + nz * nz));
+        out.x[i]         = nx * scale;
+        out.y[i]         = ny * scale;
+        out.z[i]         = nz * scale;
+    }
+}
+
+// Arvo: the center moves with m, the half extents with |m|
+inline void transformBoxes(const std::vector<Affine<>>& m, const Boxes& in, Boxes& out)
+{
+    assert(m.size() == in.size());
+    const auto size = in.size();
+    out.resize(size);
+
+    const auto half = simd::broadcast(0.5f);
+    Size       i    = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        const auto minX = simd::load(in.min.x.data() + i);
+        const auto minY = simd::load(in.min.y.data() + i);
+        const auto minZ = simd::load(in.min.z.data() + i);
+        const auto maxX = simd::load(in.max.x.data() + i);
+        const auto maxY = simd::load(in.max.y.data() + i);
+        const auto maxZ = simd::load(in.max.z.data() + i);
+        const auto cx   = simd::mul(simd::add(minX, maxX), half);
+        const auto cy   = simd::mul(simd::add(minY, maxY), half);
+        const auto cz   = simd::mul(simd::add(minZ, maxZ), half);
+        const auto ex   = simd::mul(simd::sub(maxX, minX), half);
+        const auto ey   = simd::mul(simd::sub(maxY, minY), half);
+        const auto ez   = simd::mul(simd::sub(maxZ, minZ), half);
+
+        // row r of the four matrices, transposed so that lane k holds the element of box i + k
+        const auto transformRow = [&](const Size row, float* min, float* max)
+        {
+            auto m0 = simd::load(m[i].data() + 4 * row);
+            auto m1 = simd::load(m[i + 1].data() + 4 * row);
+            auto m2 = simd::load(m[i + 2].data() + 4 * row);
+            auto m3 = simd::load(m[i + 3].data() + 4 * row);
+            simd::transpose(m0, m1, m2, m3);
+            const auto center = simd::madd(m0, cx, simd::madd(m1, cy, simd::madd(m2, cz, m3)));
+            const auto extent =
+                simd::madd(simd::abs(m0), ex, simd::madd(simd::abs(m1), ey, simd::mul(simd::abs(m2), ez)));
+            simd::store(min + i, simd::sub(center, extent));
+            simd::store(max + i, simd::add(center, extent));
+        };
+        transformRow(0, out.min.x.data(), out.max.x.data());
+        transformRow(1, out.min.y.data(), out.max.y.data());
+        transformRow(2, out.min.z.data(), out.max.z.data());
+    }
+    for (; i < size; ++i)
+    {
+        const auto&                a = m[i];
+        const std::array<float, 3> c { 0.5f * (in.min.x[i] + in.max.x[i]), 0.5f * (in.min.y[i] + in.max.y[i]),
+                                       0.5f * (in.min.z[i] + in.max.z[i]) };
+        const std::array<float, 3> e { 0.5f * (in.max.x[i] - in.min.x[i]), 0.5f * (in.max.y[i] - in.min.y[i]),
+                                       0.5f * (in.max.z[i] - in.min.z[i]) };
+        const auto                 transformRow = [&](const Size row, std::vector<float>& min, std::vector<float>& max)
+        {
+            const auto* r      = a.data() + 4 * row;
+            const auto  center = r[0] * c[0] + (r[1] * c[1] + (r[2] * c[2] + r[3]));
+            const auto  extent = std::abs(r[0]) * e[0] + (std::abs(r[1]) * e[1] + std::abs(r[2]) * e[2]);
+            min[i]             = center - extent;
+            max[i]             = center + extent;
+        };
+        transformRow(0, out.min.x, out.max.x);
+        transformRow(1, out.min.y, out.max.y);
+        transformRow(2, out.min.z, out.max.z);
+    }
+}
+
+inline void intersect(const Frustum& frustum, const Spheres& spheres, std::vector<uint8_t>& visible)
+{
+    const auto  size = spheres.size();
+    const auto& c    = spheres.center;
+    visible.resize(size);
+
+    simd::Float4 planes[6][4];
+    for (Size p = 0; p < 6; ++p)
+    {
+        const auto& [normal, distance] = frustum[p];
+        planes[p][0]                   = simd::broadcast(normal[0]);
+        planes[p][1]                   = simd::broadcast(normal[1]);
+        planes[p][2]                   = simd::broadcast(normal[2]);
+        planes[p][3]                   = simd::broadcast(distance);
+    }
+
+    Size i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        const auto x = simd::load(c.x.data() + i);
+        const auto y = simd::load(c.y.data() + i);
+        const auto z = simd::load(c.z.data() + i);
+        const auto r = simd::load(spheres.radius.data() + i);
+
+        // signed distance to the plane the sphere is the farthest outside of, offset by the radius
+        auto nearest = simd::broadcast(std::numeric_limits<float>::infinity());
+        for (const auto& [nx, ny, nz, d] : planes)
+        {
+            nearest = simd::min(nearest, simd::madd(nx, x, simd::madd(ny, y, simd::madd(nz, z, simd::add(d, r)))));
+        }
+        float distances[4];
+        simd::store(distances, nearest);
+        for (Size k = 0; k < 4; ++k)
+        {
+            visible[i + k] = distances[k] >= 0;
+        }
+    }
+    for (; i < size; ++i)
+    {
+        const auto r       = spheres.radius[i];
+        auto       nearest = std::numeric_limits<float>::infinity();
+        for (const auto& [normal, distance] : frustum)
+        {
+            const auto d = normal[0] * c.x[i] + (normal[1] * c.y[i] + (normal[2] * c.z[i] + (distance + r)));
+            nearest      = std::min(nearest, d);
+        }
+        visible[i] = nearest >= 0;
+    }
+}
+
+}  // namespace surge::math::batch
@@ -121,34 +121,12 @@ public:
     }
 
     constexpr Rotation(const Quaternion<T>& rotation)
-        : m { createMatrix(rotation) }
+        : m { toMatrix(rotation) }
     {
     }
 
     // private:
     Matrix<3, 3, T> m;
-
-private:
-    constexpr Matrix<3, 3, T> createMatrix(const Quaternion<T>& rotation)
-    {
-        const auto  xx { get<0>(rotation) * get<0>(rotation) };
-        const auto  yy { get<1>(rotation) * get<1>(rotation) };
-        const auto  zz { get<2>(rotation) * get<2>(rotation) };
-        const auto  xz { get<0>(rotation) * get<2>(rotation) };
-        const auto  xy { get<0>(rotation) * get<1>(rotation) };
-        const auto  yz { get<1>(rotation) * get<2>(rotation) };
-        const auto  wx { get<3>(rotation) * get<0>(rotation) };
-        const auto  wy { get<3>(rotation) * get<1>(rotation) };
-        const auto  wz { get<3>(rotation) * get<2>(rotation) };
-        constexpr T zero { 0 };
-        constexpr T half { 0.5 };
-        constexpr T two { 2 };
-        return two * Matrix<3, 3, T> {
-            half - yy - zz, zero + xy - wz, zero + xz + wy,  //
-            zero + xy + wz, half - xx - zz, zero + yz - wx,  //
-            zero + xz - wy, zero + yz + wx, half - xx - yy,  //
-        };
-    }
 };
 
 template<typename T>
@@ -218,6 +196,130 @@ constexpr auto& get(const Scaling<T>& t)
     }
 }
 
+// implementation: Affine
+// the top three rows of a transform whose last row is (0, 0, 0, 1), row major
+template<typename T = Float32>
+class Affine : public std::array<T, 12>
+{
+};
+
+template<typename T>
+constexpr Size rows<Affine<T>> = 4;
+
+template<typename T>
+constexpr Size cols<Affine<T>> = 4;
+
+template<Size row, Size col, typename T>
+constexpr bool nonzero<row, col, Affine<T>> = (row < 3 || col == 3);
+
+template<Size row, Size col, typename T>
+    requires ValidIndices<row, col, Affine<T>>
+constexpr auto& get(const Affine<T>& a)
+{
+    if constexpr (row < 3)
+    {
+        return a[4 * row + col];
+    }
+    else if constexpr (col == 3)
+    {
+        return one<T>;
+    }
+    else
+    {
+        return zero<T>;
+    }
+}
+
+template<Size row, Size col, typename T>
+    requires ValidIndices<row, col, Affine<T>> && (row < 3)
+constexpr auto& get(Affine<T>& a)
+{
+    return a[4 * row + col];
+}
+
+// the top three rows of m, whose last row is expected to be (0, 0, 0, 1)
+template<StaticMatrix M>
+    requires(rows<M> == 4 && cols<M> == 4)
+constexpr Affine<ValueType<M>> affine(const M& m)
+{
+    assert((get<3, 0>(m) == 0 && get<3, 1>(m) == 0 && get<3, 2>(m) == 0 && get<3, 3>(m) == 1));
+    Affine<ValueType<M>> a {};
+    forEach<0, 3, 0, 4>(
+        [&]<Size row, Size col>()
+        {
+            if constexpr (nonzero<row, col, M>)
+            {
+                get<row, col>(a) = get<row, col>(m);
+            }
+        });
+    return a;
+}
+
+// translation * rotation * scaling; the sparse products leave 9 multiplications
+template<typename T>
+constexpr Affine<T> affine(const Translation<T>& t, const Rotation<T>& r, const Scaling<T>& s)
+{
+    return affine(t * r * s);
+}
+
+// 36 multiplications instead of 64, the last row being known
+template<typename T>
+constexpr Affine<T> operator*(const Affine<T>& a, const Affine<T>& b)
+{
+    Affine<T> c {};
+    forEach<0, 3, 0, 4, 0, 3>([&]<Size row, Size col, Size mid>()
+                              { get<row, col>(c) += get<row, mid>(a) * get<mid, col>(b); });
+    forEach<0, 3>([&]<Size row>() { get<row, 3>(c) += get<row, 3>(a); });
+    return c;
+}
+
+// inverts the 3x3 linear part from its cofactors and moves the translation back through it
+template<typename T>
+Affine<T> inverse(const Affine<T>& a)
+{
+    Affine<T> inv;
+    get<0, 0>(inv) = get<1, 1>(a) * get<2, 2>(a) - get<1, 2>(a) * get<2, 1>(a);
+    get<0, 1>(inv) = get<0, 2>(a) * get<2, 1>(a) - get<0, 1>(a) * get<2, 2>(a);
+    get<0, 2>(inv) = get<0, 1>(a) * get<1, 2>(a) - get<0, 2>(a) * get<1, 1>(a);
+    get<1, 0>(inv) = get<1, 2>(a) * get<2, 0>(a) - get<1, 0>(a) * get<2, 2>(a);
+    get<1, 1>(inv) = get<0, 0>(a) * get<2, 2>(a) - get<0, 2>(a) * get<2, 0>(a);
+    get<1, 2>(inv) = get<0, 2>(a) * get<1, 0>(a) - get<0, 0>(a) * get<1, 2>(a);
+    get<2, 0>(inv) = get<1, 0>(a) * get<2, 1>(a) - get<1, 1>(a) * get<2, 0>(a);
+    get<2, 1>(inv) = get<0, 1>(a) * get<2, 0>(a) - get<0, 0>(a) * get<2, 1>(a);
+    get<2, 2>(inv) = get<0, 0>(a) * get<1, 1>(a) - get<0, 1>(a) * get<1, 0>(a);
+
+    const auto det = get<0, 0>(a) * get<0, 0>(inv) + get<0, 1>(a) * get<1, 0>(inv) + get<0, 2>(a) * get<2, 0>(inv);
+    if (det == T { 0 })
+    {
+        throw std::runtime_error("Singular matrix");
+    }
+
+    const auto invDet = T { 1 } / det;
+    forEach<0, 3, 0, 3>([&]<Size row, Size col>() { get<row, col>(inv) *= invDet; });
+    forEach<0, 3>(
+        [&]<Size row>()
+        {
+            get<row, 3>(inv) = -(get<row, 0>(inv) * get<0, 3>(a) + get<row, 1>(inv) * get<1, 3>(a) +
+                                 get<row, 2>(inv) * get<2, 3>(a));
+        });
+    return inv;
+}
+
+// for rotations and translations only: the transposed rotation undoes the rotation
+template<typename T>
+constexpr Affine<T> rigidInverse(const Affine<T>& a)
+{
+    Affine<T> inv;
+    forEach<0, 3, 0, 3>([&]<Size row, Size col>() { get<row, col>(inv) = get<col, row>(a); });
+    forEach<0, 3>(
+        [&]<Size row>()
+        {
+            get<row, 3>(inv) = -(get<row, 0>(inv) * get<0, 3>(a) + get<row, 1>(inv) * get<1, 3>(a) +
+                                 get<row, 2>(inv) * get<2, 3>(a));
+        });
+    return inv;
+}
+
 // implementation: Perspective
 template<bool _flipY, typename T = Float32>
 class Perspective
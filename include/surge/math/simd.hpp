@@ -0,0 +1,431 @@
+#pragma once
+
+// four float lanes for the 4x4 matrix and 4-vector hot paths; the backend is picked at compile time from the target:
+// SSE4.1 (with FMA when AVX2 builds enable it), NEON, or plain scalar code. Defining SURGE_MATH_SCALAR forces the
+// scalar backend, e.g. to compare against it
+#if !defined(SURGE_MATH_SCALAR) && defined(__SSE4_1__)
+#define SURGE_MATH_SSE
+#include <immintrin.h>
+#elif !defined(SURGE_MATH_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define SURGE_MATH_NEON
+#include <arm_neon.h>
+#else
+#include <algorithm>
+#include <array>
+#endif
+
+#include <cmath>
+
+namespace surge::math::simd
+{
+
+#if defined(SURGE_MATH_SSE)
+using Float4 = __m128;
+
+#if defined(__FMA__)
+constexpr const char* backend { "sse4.1 + fma" };
+#else
+constexpr const char* backend { "sse4.1" };
+#endif
+
+inline Float4 load(const float* p)
+{
+    return _mm_loadu_ps(p);
+}
+
+inline void store(float* p, const Float4 a)
+{
+    _mm_storeu_ps(p, a);
+}
+
+inline Float4 set(const float x, const float y, const float z, const float w)
+{
+    return _mm_setr_ps(x, y, z, w);
+}
+
+inline Float4 broadcast(const float a)
+{
+    return _mm_set1_ps(a);
+}
+
+inline Float4 add(const Float4 a, const Float4 b)
+{
+    return _mm_add_ps(a, b);
+}
+
+inline Float4 sub(const Float4 a, const Float4 b)
+{
+    return _mm_sub_ps(a, b);
+}
+
+inline Float4 mul(const Float4 a, const Float4 b)
+{
+    return _mm_mul_ps(a, b);
+}
+
+inline Float4 div(const Float4 a, const Float4 b)
+{
+    return _mm_div_ps(a, b);
+}
+
+// a * b + c
+inline Float4 madd(const Float4 a, const Float4 b, const Float4 c)
+{
+#if defined(__FMA__)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+// (a[x], a[y], b[z], b[w])
+template<int x, int y, int z, int w>
+Float4 shuffle(const Float4 a, const Float4 b)
+{
+    return _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x));
+}
+
+inline float first(const Float4 a)
+{
+    return _mm_cvtss_f32(a);
+}
+
+// the dot product in every lane
+inline Float4 dot(const Float4 a, const Float4 b)
+{
+    return _mm_dp_ps(a, b, 0xff);
+}
+
+inline Float4 sqrt(const Float4 a)
+{
+    return _mm_sqrt_ps(a);
+}
+
+inline Float4 abs(const Float4 a)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+}
+
+inline Float4 min(const Float4 a, const Float4 b)
+{
+    return _mm_min_ps(a, b);
+}
+
+#elif defined(SURGE_MATH_NEON)
+using Float4 = float32x4_t;
+
+constexpr const char* backend { "neon" };
+
+inline Float4 load(const float* p)
+{
+    return vld1q_f32(p);
+}
+
+inline void store(float* p, const Float4 a)
+{
+    vst1q_f32(p, a);
+}
+
+inline Float4 set(const float x, const float y, const float z, const float w)
+{
+    const float values[4] { x, y, z, w };
+    return vld1q_f32(values);
+}
+
+inline Float4 broadcast(const float a)
+{
+    return vdupq_n_f32(a);
+}
+
+inline Float4 add(const Float4 a, const Float4 b)
+{
+    return vaddq_f32(a, b);
+}
+
+inline Float4 sub(const Float4 a, const Float4 b)
+{
+    return vsubq_f32(a, b);
+}
+
+inline Float4 mul(const Float4 a, const Float4 b)
+{
+    return vmulq_f32(a, b);
+}
+
+inline Float4 div(const Float4 a, const Float4 b)
+{
+#if defined(__aarch64__)
+    return vdivq_f32(a, b);
+#else
+    const Float4 reciprocal = vrecpeq_f32(b);
+    const Float4 refined    = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    return vmulq_f32(a, vmulq_f32(vrecpsq_f32(b, refined), refined));
+#endif
+}
+
+// a * b + c
+inline Float4 madd(const Float4 a, const Float4 b, const Float4 c)
+{
+    return vmlaq_f32(c, a, b);
+}
+
+// (a[x], a[y], b[z], b[w]); lane moves, which the compiler folds into permutes
+template<int x, int y, int z, int w>
+Float4 shuffle(const Float4 a, const Float4 b)
+{
+    Float4 c = vmovq_n_f32(vgetq_lane_f32(a, x));
+    c        = vsetq_lane_f32(vgetq_lane_f32(a, y), c, 1);
+    c        = vsetq_lane_f32(vgetq_lane_f32(b, z), c, 2);
+    return vsetq_lane_f32(vgetq_lane_f32(b, w), c, 3);
+}
+
+inline float first(const Float4 a)
+{
+    return vgetq_lane_f32(a, 0);
+}
+
+// the dot product in every lane
+inline Float4 dot(const Float4 a, const Float4 b)
+{
+    const Float4 c   = vmulq_f32(a, b);
+    const auto   sum = vadd_f32(vget_low_f32(c), vget_high_f32(c));
+    return vdupq_lane_f32(vpadd_f32(sum, sum), 0);
+}
+
+inline Float4 sqrt(const Float4 a)
+{
+#if defined(__aarch64__)
+    return vsqrtq_f32(a);
+#else
+    return set(std::sqrt(vgetq_lane_f32(a, 0)), std::sqrt(vgetq_lane_f32(a, 1)), std::sqrt(vgetq_lane_f32(a, 2)),
+               std::sqrt(vgetq_lane_f32(a, 3)));
+#endif
+}
+
+inline Float4 abs(const Float4 a)
+{
+    return vabsq_f32(a);
+}
+
+inline Float4 min(const Float4 a, const Float4 b)
+{
+    return vminq_f32(a, b);
+}
+
+#else
+using Float4 = std::array<float, 4>;
+
+constexpr const char* backend { "scalar" };
+
+inline Float4 load(const float* p)
+{
+    return { p[0], p[1], p[2], p[3] };
+}
+
+inline void store(float* p, const Float4 a)
+{
+    p[0] = a[0];
+    p[1] = a[1];
+    p[2] = a[2];
+    p[3] = a[3];
+}
+
+inline Float4 set(const float x, const float y, const float z, const float w)
+{
+    return { x, y, z, w };
+}
+
+inline Float4 broadcast(const float a)
+{
+    return { a, a, a, a };
+}
+
+inline Float4 add(const Float4 a, const Float4 b)
+{
+    return { a[0] + b[0], a[1] + b[1], a[2] + b[2], a[3] + b[3] };
+}
+
+inline Float4 sub(const Float4 a, const Float4 b)
+{
+    return { a[0] - b[0], a[1] - b[1], a[2] - b[2], a[3] - b[3] };
+}
+
+inline Float4 mul(const Float4 a, const Float4 b)
+{
+    return { a[0] * b[0], a[1] * b[1], a[2] * b[2], a[3] * b[3] };
+}
+
+inline Float4 div(const Float4 a, const Float4 b)
+{
+    return { a[0] / b[0], a[1] / b[1], a[2] / b[2], a[3] / b[3] };
+}
+
+// a * b + c
+inline Float4 madd(const Float4 a, const Float4 b, const Float4 c)
+{
+    return add(mul(a, b), c);
+}
+
+// (a[x], a[y], b[z], b[w])
+template<int x, int y, int z, int w>
+Float4 shuffle(const Float4 a, const Float4 b)
+{
+    return { a[x], a[y], b[z], b[w] };
+}
+
+inline float first(const Float4 a)
+{
+    return a[0];
+}
+
+// the dot product in every lane
+inline Float4 dot(const Float4 a, const Float4 b)
+{
+    const auto d = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    return { d, d, d, d };
+}
+
+inline Float4 sqrt(const Float4 a)
+{
+    return { std::sqrt(a[0]), std::sqrt(a[1]), std::sqrt(a[2]), std::sqrt(a[3]) };
+}
+
+inline Float4 abs(const Float4 a)
+{
+    return { std::abs(a[0]), std::abs(a[1]), std::abs(a[2]), std::abs(a[3]) };
+}
+
+inline Float4 min(const Float4 a, const Float4 b)
+{
+    return { std::min(a[0], b[0]), std::min(a[1], b[1]), std::min(a[2], b[2]), std::min(a[3], b[3]) };
+}
+#endif
+
+template<int x, int y, int z, int w>
+Float4 swizzle(const Float4 a)
+{
+    return shuffle<x, y, z, w>(a, a);
+}
+
+template<int lane>
+Float4 splat(const Float4 a)
+{
+    return shuffle<lane, lane, lane, lane>(a, a);
+}
+
+// rows a b c d become columns
+inline void transpose(Float4& a, Float4& b, Float4& c, Float4& d)
+{
+    const Float4 ab01 = shuffle<0, 1, 0, 1>(a, b);
+    const Float4 ab23 = shuffle<2, 3, 2, 3>(a, b);
+    const Float4 cd01 = shuffle<0, 1, 0, 1>(c, d);
+    const Float4 cd23 = shuffle<2, 3, 2, 3>(c, d);
+    a                 = shuffle<0, 2, 0, 2>(ab01, cd01);
+    b                 = shuffle<1, 3, 1, 3>(ab01, cd01);
+    c                 = shuffle<0, 2, 0, 2>(ab23, cd23);
+    d                 = shuffle<1, 3, 1, 3>(ab23, cd23);
+}
+
+// c = a b for row major 4x4 matrices: every row of c combines the rows of b weighted by a row of a
+inline void multiply(const float* a, const float* b, float* c)
+{
+    const Float4 b0 = load(b);
+    const Float4 b1 = load(b + 4);
+    const Float4 b2 = load(b + 8);
+    const Float4 b3 = load(b + 12);
+    for (int row = 0; row < 4; ++row)
+    {
+        const Float4 r = load(a + 4 * row);
+        Float4       s = mul(splat<0>(r), b0);
+        s              = madd(splat<1>(r), b1, s);
+        s              = madd(splat<2>(r), b2, s);
+        s              = madd(splat<3>(r), b3, s);
+        store(c + 4 * row, s);
+    }
+}
+
+// 2x2 blocks held row major in one register
+// a b
+inline Float4 block2Multiply(const Float4 a, const Float4 b)
+{
+    return madd(a, swizzle<0, 3, 0, 3>(b), mul(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+
+// adj(a) b
+inline Float4 block2AdjugateMultiply(const Float4 a, const Float4 b)
+{
+    return sub(mul(swizzle<3, 3, 0, 0>(a), b), mul(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+}
+
+// a adj(b)
+inline Float4 block2MultiplyAdjugate(const Float4 a, const Float4 b)
+{
+    return sub(mul(a, swizzle<3, 0, 3, 0>(b)), mul(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+
+// inverse of a row major 4x4 matrix from its 2x2 blocks A B / C D, returns the determinant, inv is left unwritten
+// when it is 0
+inline float inverse(const float* m, float* inv)
+{
+    const Float4 r0 = load(m);
+    const Float4 r1 = load(m + 4);
+    const Float4 r2 = load(m + 8);
+    const Float4 r3 = load(m + 12);
+
+    const Float4 a = shuffle<0, 1, 0, 1>(r0, r1);
+    const Float4 b = shuffle<2, 3, 2, 3>(r0, r1);
+    const Float4 c = shuffle<0, 1, 0, 1>(r2, r3);
+    const Float4 d = shuffle<2, 3, 2, 3>(r2, r3);
+
+    // (|A|, |B|, |C|, |D|)
+    const Float4 determinants = sub(mul(shuffle<0, 2, 0, 2>(r0, r2), shuffle<1, 3, 1, 3>(r1, r3)),
+                                    mul(shuffle<1, 3, 1, 3>(r0, r2), shuffle<0, 2, 0, 2>(r1, r3)));
+    const Float4 detA         = splat<0>(determinants);
+    const Float4 detB         = splat<1>(determinants);
+    const Float4 detC         = splat<2>(determinants);
+    const Float4 detD         = splat<3>(determinants);
+
+    const Float4 adjDC = block2AdjugateMultiply(d, c);
+    const Float4 adjAB = block2AdjugateMultiply(a, b);
+
+    // adjugates of the blocks of the inverse, scaled by |M|
+    Float4 x = sub(mul(detD, a), block2Multiply(b, adjDC));
+    Float4 w = sub(mul(detA, d), block2Multiply(c, adjAB));
+    Float4 y = sub(mul(detB, c), block2MultiplyAdjugate(d, adjAB));
+    Float4 z = sub(mul(detC, b), block2MultiplyAdjugate(a, adjDC));
+
+    // |M| = |A| |D| + |B| |C| - tr(adj(A) B adj(D) C)
+    const Float4 trace       = dot(adjAB, swizzle<0, 2, 1, 3>(adjDC));
+    const Float4 determinant = sub(madd(detA, detD, mul(detB, detC)), trace);
+    if (first(determinant) == 0)
+    {
+        return 0;
+    }
+
+    const Float4 scale = div(set(1, -1, -1, 1), determinant);
+    x                  = mul(x, scale);
+    y                  = mul(y, scale);
+    z                  = mul(z, scale);
+    w                  = mul(w, scale);
+
+    // transposing the adjugates back into rows
+    store(inv, shuffle<3, 1, 3, 1>(x, y));
+    store(inv + 4, shuffle<2, 0, 2, 0>(x, y));
+    store(inv + 8, shuffle<3, 1, 3, 1>(z, w));
+    store(inv + 12, shuffle<2, 0, 2, 0>(z, w));
+    return first(determinant);
+}
+
+inline float dot4(const float* a, const float* b)
+{
+    return first(dot(load(a), load(b)));
+}
+
+// b = a / |a|
+inline void normalize4(const float* a, float* b)
+{
+    const Float4 v = load(a);
+    store(b, div(v, sqrt(dot(v, v))));
+}
+
+}  // namespace surge::math::simd
@@ -27,6 +27,33 @@ std::pair<math::Vector<2>, math::Vector<2>> overlay(const asset::Asset&    asset
     ImGui::Begin(asset.name.c_str(), nullptr, windowOptions);
 
     ImGui::Checkbox("active", &asset.state.active);
+    ImGui::Checkbox("depth pre-pass", &asset.state.depthPrePass);
+
+    if (ImGui::CollapsingHeader("Loading", ImGuiTreeNodeFlags_None))
+    {
+        constexpr auto megabytes = [](const Size bytes) { return static_cast<double>(bytes) / (1024 * 1024); };
+        const auto&    loading   = asset.loadStatistics;
+        ImGui::Text("parse time:  %.1f ms", 1e3 * loading.seconds);
+        ImGui::Text("mapped:      %.1f MiB", megabytes(loading.mappedBytes));
+        ImGui::Text("copied:      %.1f MiB", megabytes(loading.copiedBytes));
+        ImGui::Text("peak RSS:    %.1f MiB", megabytes(loading.peakResidentBytes));
+        ImGui::Text("cache:       %s", loading.cached ? "warm" : "cold");
+        ImGui::Text("hash time:   %.1f ms", 1e3 * loading.hashSeconds);
+        ImGui::Text("textures:    %.1f ms", 1e3 * loading.textureSeconds);
+        ImGui::Text("model:       %.1f ms", 1e3 * loading.modelSeconds);
+        ImGui::Text("vertex:      %u bytes", asset.layout.vertexSize());
+        ImGui::Text("index:       %u bytes", asset.model.indexType == VK_INDEX_TYPE_UINT16 ? 2u : 4u);
+        if (loading.vertexCacheBefore.triangles > 0)
+        {
+            ImGui::Text("ACMR:        %.3f -> %.3f", loading.vertexCacheBefore.acmr(), loading.vertexCacheAfter.acmr());
+            ImGui::Text("ATVR:        %.3f -> %.3f", loading.vertexCacheBefore.atvr(), loading.vertexCacheAfter.atvr());
+        }
+        else
+        {
+            ImGui::Text("ACMR:        %.3f", loading.vertexCacheAfter.acmr());
+            ImGui::Text("ATVR:        %.3f", loading.vertexCacheAfter.atvr());
+        }
+    }
 
     if (ImGui::CollapsingHeader(("Textures: " + std::to_string(asset.textures.size())).c_str(),
                                 ImGuiTreeNodeFlags_None))
@@ -96,6 +123,7 @@ std::pair<math::Vector<2>, math::Vector<2>> overlay(const asset::Asset&    asset
                         ImGui::Text("first index:  %d", primitive.firstIndex);
                         ImGui::Text("index count:  %d", primitive.indexCount);
                         ImGui::Text("vertex count: %d", primitive.vertexCount);
+                        ImGui::Text("first vertex: %d", primitive.vertexOffset);
                         ImGui::Text("material:     %s", primitive.material.name.c_str());
                         ImGui::Text("position:     %s",
                                     to_string(primitive.attributes.at(geometry::Attribute::position)));
@@ -116,6 +144,7 @@ std::pair<math::Vector<2>, math::Vector<2>> overlay(const asset::Asset&    asset
                         ImGui::TreePop();
                     }
                 }
+                ImGui::Text("targets: %zu", mesh.targets.size());
                 ImGui::TreePop();
             }
         }
@@ -139,8 +168,40 @@ std::pair<math::Vector<2>, math::Vector<2>> overlay(const asset::Asset&    asset
         }
     }
 
+    ImGui::Text("gpu skinning: %.3f ms", asset.state.gpuTime.skinning);
+    ImGui::Text("gpu draw:     %.3f ms", asset.state.gpuTime.draw);
+
+    if (!asset.animations.empty() && ImGui::CollapsingHeader("Animation LOD", ImGuiTreeNodeFlags_None))
+    {
+        const auto& schedule = asset.state.schedule;
+        ImGui::Checkbox("enabled", &asset.state.lod.enabled);
+        ImGui::Checkbox("interpolate", &asset.state.lod.interpolate);
+        ImGui::Text("visible:     %s", to_string(schedule.visible));
+        ImGui::Text("coverage:    %.3f", schedule.coverage);
+        ImGui::Text("interval:    %s", schedule.interval ? std::to_string(schedule.interval).c_str() : "frozen");
+        ImGui::Text("leaf joints: %s", schedule.skipLeafJoints ? "rest" : "animated");
+    }
+
     if (ImGui::CollapsingHeader(("Skins: " + std::to_string(asset.skins.size())).c_str(), ImGuiTreeNodeFlags_Framed))
     {
+        if (asset.morphTargets)
+        {
+            ImGui::Text("compute skinning: always, for the morph targets");
+        }
+        else if (!asset.skins.empty())
+        {
+            ImGui::Checkbox("compute skinning", &asset.state.computeSkinning);
+        }
+        if (!asset.skins.empty())
+        {
+            ImGui::Text("method: %s", asset.skinningMethod == asset::SkinningMethod::dualQuaternion ?
+                                          "dual quaternion" :
+                                          "linear");
+        }
+        if (asset.morphTargets)
+        {
+            ImGui::Text("morph deltas: %u", asset.morphTargets->deltaCount);
+        }
         uint32_t skinId {};
         for (const auto& skin : asset.skins)
         {
@@ -169,12 +230,38 @@ std::pair<math::Vector<2>, math::Vector<2>> overlay(const asset::Asset&    asset
         {
             if (ImGui::TreeNode(idName(animationsId++, animation.name).c_str()))
             {
-                ImGui::Text("active:   %s", to_string(animation.state.active));
+                ImGui::Checkbox("active", &animation.state.active);
+                ImGui::SliderFloat("weight", &animation.state.weight, 0.0f, 1.0f);
+                auto additive = animation.state.blending == asset::Animation::Blending::additive;
+                if (ImGui::Checkbox("additive", &additive))
+                {
+                    animation.state.blending = additive ? asset::Animation::Blending::additive :
+                                                          asset::Animation::Blending::mix;
+                }
                 ImGui::Text("progress: %f", animation.state.progress);
                 ImGui::Text("start:    %f", animation.start);
                 ImGui::Text("end:      %f", animation.end);
                 ImGui::Text("samplers: %d", static_cast<int>(animation.samplers.size()));
                 ImGui::Text("channels: %d", static_cast<int>(animation.channels.size()));
+                ImGui::Text("memory:   %zu B", animation.bytes());
+                if (animation.compression)
+                {
+                    const auto& compression = animation.compression.value();
+                    ImGui::Text("raw:      %zu B", compression.rawBytes);
+                    ImGui::Text("ratio:    %.2f", static_cast<float>(compression.rawBytes) / compression.bytes);
+                    ImGui::Text("error:    %g", compression.tolerance);
+                }
+                if (animation.baked)
+                {
+                    const auto& baked = animation.baked.value();
+                    ImGui::Text("baked:    %zu frames at %g Hz", baked.frameCount, baked.rate);
+                    ImGui::Text("table:    %zu B", baked.bytes());
+                    ImGui::Text("error:    %g", baked.error);
+                }
+                else if (animation.refusedBakeError)
+                {
+                    ImGui::Text("baked:    no, error %g over budget", animation.refusedBakeError.value());
+                }
                 // if (ImGui::TreeNode(("samplers: " + std::to_string(animation.samplers.size())).c_str()))
                 // {
                 //     uint32_t samplerId = 0;
@@ -189,46 +276,56 @@ std::pair<math::Vector<2>, math::Vector<2>> overlay(const asset::Asset&    asset
         }
     }
 
-    if (ImGui::CollapsingHeader(("Joint Matrices: " + std::to_string(asset.state.jointMatrices.size())).c_str(),
+    if (ImGui::CollapsingHeader(("Joint Palettes: " + std::to_string(asset.jointPalettes.size())).c_str(),
                                 ImGuiTreeNodeFlags_None))
     {
-        uint32_t jointMatrixId {};
-        for (const auto& jointMatrix : asset.state.jointMatrices)
+        ImGui::Text("uploaded: %zu bytes/frame", asset.state.uploadedBytes);
+        uint32_t paletteId {};
+        for (const auto& palette : asset.jointPalettes)
         {
-            const auto jointMatrixName = idName(jointMatrixId++, "joint matrix");
-            if (ImGui::TreeNode(jointMatrixName.c_str()))
+            if (ImGui::TreeNode(idName(paletteId++, palette.node.name).c_str()))
             {
-                ImGui::Text("%s", math::toString(jointMatrix).c_str());
-                math::Vector<4> row0 {
-                    math::get<0, 0>(jointMatrix),
-                    math::get<0, 1>(jointMatrix),
-                    math::get<0, 2>(jointMatrix),
-                    math::get<0, 3>(jointMatrix),
-                };
-                math::Vector<4> row1 {
-                    math::get<1, 0>(jointMatrix),
-                    math::get<1, 1>(jointMatrix),
-                    math::get<1, 2>(jointMatrix),
-                    math::get<1, 3>(jointMatrix),
-                };
-                math::Vector<4> row2 {
-                    math::get<2, 0>(jointMatrix),
-                    math::get<2, 1>(jointMatrix),
-                    math::get<2, 2>(jointMatrix),
-                    math::get<2, 3>(jointMatrix),
-                };
-                math::Vector<4> row3 {
-                    math::get<3, 0>(jointMatrix),
-                    math::get<3, 1>(jointMatrix),
-                    math::get<3, 2>(jointMatrix),
-                    math::get<3, 3>(jointMatrix),
-                };
-
-                slider("", jointMatrixName + "0", row0, xyzw);
-                slider("", jointMatrixName, row1, xyzw);
-                slider("", jointMatrixName, row2, xyzw);
-                slider("", jointMatrixName, row3, xyzw);
+                ImGui::Text("offset: %u", palette.offset);
+                uint32_t jointMatrixId {};
+                for (const auto& jointMatrix : palette.matrices)
+                {
+                    const auto jointMatrixName = idName(jointMatrixId++, "joint matrix");
+                    if (ImGui::TreeNode(jointMatrixName.c_str()))
+                    {
+                        ImGui::Text("%s", math::toString(jointMatrix).c_str());
+                        math::Vector<4> row0 {
+                            math::get<0, 0>(jointMatrix),
+                            math::get<0, 1>(jointMatrix),
+                            math::get<0, 2>(jointMatrix),
+                            math::get<0, 3>(jointMatrix),
+                        };
+                        math::Vector<4> row1 {
+                            math::get<1, 0>(jointMatrix),
+                            math::get<1, 1>(jointMatrix),
+                            math::get<1, 2>(jointMatrix),
+                            math::get<1, 3>(jointMatrix),
+                        };
+                        math::Vector<4> row2 {
+                            math::get<2, 0>(jointMatrix),
+                            math::get<2, 1>(jointMatrix),
+                            math::get<2, 2>(jointMatrix),
+                            math::get<2, 3>(jointMatrix),
+                        };
+                        math::Vector<4> row3 {
+                            math::get<3, 0>(jointMatrix),
+                            math::get<3, 1>(jointMatrix),
+                            math::get<3, 2>(jointMatrix),
+                            math::get<3, 3>(jointMatrix),
+                        };
 
+                        slider("", jointMatrixName + "0", row0, xyzw);
+                        slider("", jointMatrixName, row1, xyzw);
+                        slider("", jointMatrixName, row2, xyzw);
+                        slider("", jointMatrixName, row3, xyzw);
+
+                        ImGui::TreePop();
+                    }
+                }
                 ImGui::TreePop();
             }
         }
@@ -105,6 +105,10 @@ static void overlay(const asset::Node& node, uint32_t& nodeId)
         slider("scale       ", node.name, node.state.scale, xyzw);
         ImGui::Text("mesh:  %s", node.mesh ? node.mesh->name.c_str() : "none");
         ImGui::Text("skin:  %s", node.skinIndex ? std::to_string(node.skinIndex.value()).c_str() : "none");
+        for (uint32_t target = 0; target < node.state.weights.size(); ++target)
+        {
+            ImGui::SliderFloat(idName(target, node.name + " weight").c_str(), &node.state.weights[target], 0.0f, 1.0f);
+        }
 
         if (node.children.empty())
         {
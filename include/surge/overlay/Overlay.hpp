@@ -7,6 +7,7 @@
 #include "surge/Model.hpp"
 #include "surge/Descriptor.hpp"
 #include "surge/asset/Asset.hpp"
+#include "surge/asset/Crowd.hpp"
 
 #include "surge/overlay/Font.hpp"
 #include "surge/overlay/LoadedOverlay.hpp"
@@ -14,7 +15,12 @@
 
 #include <imgui.h>
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <ranges>
 
 namespace surge::overlay
 {
@@ -31,7 +37,8 @@ public:
 
 
     Overlay(const Command& command, const std::filesystem::path& shaders, UserInteraction&,
-            const std::vector<asset::Asset>& assets)
+            const std::vector<asset::Asset>& assets, const std::vector<asset::Crowd>& crowds,
+            const std::vector<std::unique_ptr<asset::Asset>>& streamed)
         : imGuiContext { 1 }
         , fontTexture { command, Font {}, SceneTextureInfo {} }
         , model {}
@@ -84,13 +91,19 @@ public:
                                     VK_COLOR_COMPONENT_A_BIT,
               }) }
         , assets { assets }
+        , crowds { crowds }
+        , streamed { streamed }
     {
     }
 
 
     static void newFrame(const VkExtent2D extent, const float scale, std::array<float, 50>& frameTimes,
-                         const UserInteraction& ui, const std::vector<asset::Asset>& assets)
+                         const UserInteraction& ui, const std::vector<const asset::Asset*>& assets,
+                         const std::vector<asset::Crowd>& crowds)
     {
+        // stress tests load hundreds of assets, only the first ones get a window
+        constexpr std::size_t maxAssetWindows { 8 };
+
         ImGuiIO& io                = ImGui::GetIO();
         io.DisplaySize             = ImVec2(extent.width, extent.height);
         io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
@@ -138,6 +151,34 @@ public:
         //             ui.firstPersonCamera.front.z);
 
         ImGui::Text("active mouse: %s", ui.mouseActive ? "true" : "false");
+
+        // animation level of detail, counted per update interval: frozen, every frame, every 2nd, every 4th
+        std::array<std::size_t, 5> intervals {};
+        for (const auto* asset : assets)
+        {
+            ++intervals.at(std::min<std::size_t>(asset->state.schedule.interval, 4));
+        }
+        ImGui::Text("assets: %zu", assets.size());
+        ImGui::Text("animated 1/2/4/frozen: %zu/%zu/%zu/%zu", intervals[1], intervals[2], intervals[4], intervals[0]);
+        // the assets without a window are toggled together
+        if (assets.size() > maxAssetWindows)
+        {
+            const auto others = assets | std::views::drop(maxAssetWindows);
+            bool active = std::ranges::all_of(others, [](const asset::Asset* asset) { return asset->state.active; });
+            if (ImGui::Checkbox(("other " + std::to_string(assets.size() - maxAssetWindows) + " assets").c_str(),
+                                &active))
+            {
+                for (const auto* asset : others)
+                {
+                    asset->state.active = active;
+                }
+            }
+        }
+        for (const auto& crowd : crowds)
+        {
+            ImGui::Checkbox(("crowd of " + std::to_string(crowd.instanceCount()) + " " + crowd.asset.name).c_str(),
+                            &crowd.state.active);
+        }
         // ImGui::Text("shadow map: %s", ui.shadowMap ? "true" : "false");
 
         // ImGui::Text("light pos: %f, %f, %f", ui.lightPos[0], ui.lightPos[1], ui.lightPos[2]);
@@ -163,9 +204,9 @@ public:
 
         math::Vector<2> previousWindowPosition { pos.x, pos.y };
         math::Vector<2> previousWindowSize { size.x, size.y };
-        for (const auto& asset : assets)
+        for (const auto* asset : assets | std::views::take(maxAssetWindows))
         {
-            const auto [pos, size] = overlay(asset, previousWindowPosition, previousWindowSize);
+            const auto [pos, size] = overlay(*asset, previousWindowPosition, previousWindowSize);
             previousWindowPosition = pos;
             previousWindowSize     = size;
         }
@@ -195,7 +236,10 @@ public:
         // Update buffers only if vertex or index count has been changed compared to current buffer size
         if (!model || model->vertexCount != vertexCount || model->indexCount != indexCount)
         {
-            vkQueueWaitIdle(graphicsQueue);
+            {
+                const std::lock_guard lock { context().queueMutexes[0] };
+                vkQueueWaitIdle(graphicsQueue);
+            }
             model.emplace(loadedOverlay, ImGuiModelInfo {});
         }
         model->transfer(loadedOverlay);
@@ -203,7 +247,12 @@ public:
 
     void update(const VkExtent2D extent, const UserInteraction& userInteraction) const
     {
-        newFrame(extent, imGuiContext.scale, frameTimes, userInteraction, assets);
+        // the streamed assets follow the loaded ones as they are published
+        std::vector<const asset::Asset*> all;
+        all.reserve(assets.size() + streamed.size());
+        std::ranges::transform(assets, std::back_inserter(all), [](const asset::Asset& asset) { return &asset; });
+        std::ranges::transform(streamed, std::back_inserter(all), [](const auto& asset) { return asset.get(); });
+        newFrame(extent, imGuiContext.scale, frameTimes, userInteraction, all, crowds);
         updateBuffers(graphicsQueue, model);
     }
 
@@ -261,7 +310,7 @@ public:
         {
             VkDeviceSize offsets[1] = { 0 };
             vkCmdBindVertexBuffers(commandBuffer, 0, 1, &model->vertexBuffer.buffer, offsets);
-            vkCmdBindIndexBuffer(commandBuffer, model->indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT16);
+            vkCmdBindIndexBuffer(commandBuffer, model->indexBuffer.buffer, 0, model->indexType);
 
             for (int32_t i = 0; i < imDrawData->CmdListsCount; i++)
             {
@@ -331,6 +380,9 @@ private:
     VkPipeline       pipeline;
 
     const std::vector<asset::Asset>& assets;
+    const std::vector<asset::Crowd>& crowds;
+
+    const std::vector<std::unique_ptr<asset::Asset>>& streamed;  // owned by the streamer
 };
 
 }  // namespace surge::overlay
@@ -6,6 +6,9 @@ namespace surge
 using Int8  = char;
 using UInt8 = unsigned char;
 
+using Int16  = short;
+using UInt16 = unsigned short;
+
 using Int32  = int;
 using UInt32 = unsigned int;
 
@@ -4,24 +4,18 @@
 
 #include <cassert>
 #include <tuple>
+#include <utility>
 
 namespace surge
 {
+// unrolled by a fold expression rather than by recursion, which the inliner gives up on for the nested loops of
+// the matrix products
 template<Size begin, Size end, typename Operation>
 constexpr void forEach(const Operation& operation)
 {
-    if constexpr (begin == end)
-    {
-        return;
-    }
-    else
-    {
-        operation.template operator()<begin>();
-        if constexpr (begin < end - 1)
-        {
-            forEach<begin + 1, end>(operation);
-        }
-    }
+    static_assert(begin <= end);
+    [&]<Size... indices>(std::index_sequence<indices...>)
+    { (operation.template operator()<begin + indices>(), ...); }(std::make_index_sequence<end - begin> {});
 }
 
 template<Size begin0, Size end0, Size begin1, Size end1, typename Operation>
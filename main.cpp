@@ -13,12 +13,16 @@
 // #include "ShadowMap.hpp"
 
 #include "surge/asset/Asset.hpp"
+#include "surge/asset/Crowd.hpp"
 
 #include "surge/Renderer.hpp"
+#include "surge/Streamer.hpp"
 
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <optional>
 
 #include <filesystem>
@@ -42,9 +46,12 @@ public:
         , defaults { command, resources }
         , skybox { command, resources.at("shaders"), resources.at("skyboxTexture") }
         , assets { createAssets(command, resources) }
-        , renderer { resources.at("shaders"), assets }
-        , overlay { command, resources.at("shaders"), userInteraction, assets }
+        , crowds { createCrowds(assets) }
+        , renderer { resources.at("shaders"), assets, crowds }
+        , streamer { defaults, renderer }
+        , overlay { command, resources.at("shaders"), userInteraction, assets, crowds, streamer.assets }
     {
+        requestAssets(resources);
     }
 
     void run()
@@ -60,7 +67,7 @@ public:
                 userInteraction.reset();
                 surge::context().pollEvents();
 
-                render(presenter, userInteraction, skybox, renderer, /*shadowMap, scene,*/
+                render(presenter, userInteraction, skybox, renderer, streamer, /*shadowMap, scene,*/
                        overlay);
                 start = std::chrono::high_resolution_clock::now();
             }
@@ -69,6 +76,10 @@ public:
             elapsedTime     = 1e-3 * std::chrono::duration<double, std::milli>(stop - start).count();
             ++ticCount;
         }
+
+        // no load may submit past this point, and waiting for the device idle touches every queue
+        streamer.stop();
+        const std::scoped_lock lock { surge::context().queueMutexes[0], surge::context().queueMutexes[1] };
         vkDeviceWaitIdle(surge::context().device);
     }
 
@@ -94,7 +105,9 @@ private:
     surge::Skybox skybox;
 
     std::vector<surge::asset::Asset> assets;
+    std::vector<surge::asset::Crowd> crowds;
     surge::Renderer                  renderer;
+    surge::Streamer                  streamer;
 
     surge::overlay::Overlay overlay;
 
@@ -113,18 +126,16 @@ private:
         assets.reserve(names.size() + 1);
         for (const auto& name : names)
         {
-            assets.emplace_back(command, defaults, surge::asset::GltfAsset { name, resources.at(name) });
+            assets.emplace_back(command, defaults, surge::asset::GltfAsset { name, resources.at(name) })
+                .activate({ 0.0f, 0.0f, 0.0f });
         }
 
         // assets.emplace_back(command, defaults,
         //                     surge::asset::ObjAsset { "viking room", resources.at("vikingRoomModel"),
         //                                              resources.at("vikingRoomTexture") });
 
-        // activate oaktree
-
         for (auto& asset : assets)
         {
-            asset.state.active = true;
             for (auto& mesh : asset.meshes)
             {
                 for (auto& primitive : mesh.primitives)
@@ -132,18 +143,73 @@ private:
                     primitive.state.boundingBox = true;
                 }
             }
-            for (auto& node : asset.mainScene().nodes)
-            {
-                node.state.active = true;
-                for (auto& child : node.children)
-                {
-                    child.state.active = true;
-                }
-            }
         }
 
         return assets;
     }
+
+    // assets loaded while rendering, drawn as boxes until they are resident
+    void requestAssets(const std::map<std::string, std::filesystem::path>& resources)
+    {
+        constexpr std::array names { "oaktree" };
+
+        // animation level of detail stress test: a square grid of skinned instances, streamed in behind the other
+        // assets and toggled together from the overlay; 0 turns it off
+        constexpr uint32_t stressInstances { 256 };
+        constexpr float    stressSpacing { 2.0f };
+
+        for (uint32_t i = 0; i < names.size(); ++i)
+        {
+            streamer.request(surge::Streamer::Request {
+                .name        = names[i],
+                .path        = resources.at(names[i]),
+                .translation = { 2.0f * static_cast<float>(i + 1), 0.0f, 0.0f },
+                .extent      = { 1.0f, 2.0f, 1.0f },
+            });
+        }
+
+        const auto columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(stressInstances))));
+        for (uint32_t i = 0; i < stressInstances; ++i)
+        {
+            streamer.request(surge::Streamer::Request {
+                .name        = "simple " + std::to_string(i),
+                .path        = resources.at("simple"),
+                .translation = { stressSpacing * static_cast<float>(i % columns), 0.0f,
+                                 -stressSpacing * static_cast<float>(i / columns + 1) },
+            });
+        }
+    }
+
+    // crowd stress test: a square grid of instances of the first asset, drawn with one call per primitive and toggled
+    // from the overlay
+    static std::vector<surge::asset::Crowd> createCrowds(const std::vector<surge::asset::Asset>& assets)
+    {
+        constexpr uint32_t crowdInstances { 400 };
+        constexpr float    crowdSpacing { 1.0f };
+
+        std::vector<surge::asset::Crowd> crowds;
+        const auto&                      asset = assets.front();
+        if (crowdInstances == 0 || asset.animations.empty())
+        {
+            return crowds;
+        }
+
+        const auto columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(crowdInstances))));
+        std::vector<surge::asset::Crowd::Instance> instances;
+        instances.reserve(crowdInstances);
+        for (uint32_t i = 0; i < crowdInstances; ++i)
+        {
+            instances.push_back(surge::asset::Crowd::Instance {
+                .translation = { crowdSpacing * static_cast<float>(i % columns), 0.0f,
+                                 crowdSpacing * static_cast<float>(i / columns + 1) },
+                .animation   = static_cast<uint32_t>(i % asset.animations.size()),
+                .timeOffset  = 0.1f * static_cast<float>(i % 16),
+            });
+        }
+        crowds.reserve(1);
+        crowds.emplace_back(asset, instances, 30.0f);
+        return crowds;
+    }
 };
 
 int main(int argc, char* argv[])
@@ -0,0 +1,25 @@
+#version 450
+
+// input ========================================
+// the position stream alone, static or skinned by skinning.comp
+layout(location = 0) in vec3 inPosition;
+
+layout(push_constant) uniform PushConstants
+{
+    mat4 model;
+};
+
+layout(set = 0, binding = 0) uniform Scene
+{
+    mat4 projection;
+    mat4 view;
+};
+
+// output =======================================
+// computed as by the shaders of the main pass, so that their fragments pass the equal depth test
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = vec4(inPosition, 1.0) * model * view * projection;
+}
@@ -1,11 +1,11 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 // input ========================================
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec3 inNormal;
+layout(location = 2) in vec2 inNormal;  // octahedral
 layout(location = 3) in vec2 inTexCoord;
-layout(location = 4) in vec4 inJointIndices;
+layout(location = 4) in uvec4 inJointIndices;
 layout(location = 5) in vec4 inJointWeights;
 
 layout(push_constant) uniform PushConstants
@@ -14,6 +14,7 @@ layout(push_constant) uniform PushConstants
     vec4 baseColorFactor;
     uint vertexStageFlag;
     uint fragmentStageFlag;
+    uint jointOffset;
 };
 
 layout(set = 0, binding = 0) uniform Scene
@@ -22,9 +23,13 @@ layout(set = 0, binding = 0) uniform Scene
     mat4 view;
 };
 
-layout(set = 2, binding = 0) readonly buffer JointMatrices
+// 0: linear blending of a matrix per joint, 1: a dual quaternion per joint
+layout(constant_id = 0) const uint skinningMethod = 0u;
+
+// matrices or dual quaternions depending on skinningMethod
+layout(set = 2, binding = 0) readonly buffer JointPalette
 {
-    mat4 jointMatrices[];
+    vec4 palette[];
 };
 
 // output =======================================
@@ -34,6 +39,9 @@ layout(location = 2) out vec3 outNormal;
 layout(location = 3) out vec3 outViewVec;
 layout(location = 4) out vec3 outLightVec;
 
+#include "octahedral.glsl"
+#include "skinning.glsl"
+
 void main()
 {
     // pass on
@@ -41,15 +49,12 @@ void main()
     outColor    = vec3(1.0f, 1.0f, 1.0f);
 
     // skinning
-    mat4 skin = inJointWeights.x * jointMatrices[int(inJointIndices.x)] +
-                inJointWeights.y * jointMatrices[int(inJointIndices.y)] +
-                inJointWeights.z * jointMatrices[int(inJointIndices.z)] +
-                inJointWeights.w * jointMatrices[int(inJointIndices.w)];
-    gl_Position = vec4(inPosition, 1.0) * skin * model * view * projection;
+    Skin skin   = blendJoints(jointOffset, inJointIndices, inJointWeights);
+    gl_Position = vec4(skinPosition(skin, inPosition), 1.0) * model * view * projection;
 
     // light
     vec4 lightPosition = vec4(5.0f, 5.0f, 5.0f, 1.0f);
-    outNormal          = inverse(mat3(skin * model * view)) * inNormal;
+    outNormal          = inverse(mat3(model * view)) * skinNormal(skin, decodeOctahedral(inNormal));
     vec4 pos           = vec4(inPosition, 1.0) * view;
     outLightVec        = lightPosition.xyz * mat3(view) - pos.xyz;
     outViewVec         = -pos.xyz;
@@ -0,0 +1,70 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// input ========================================
+layout(location = 0) in vec3 inPosition;
+layout(location = 2) in vec2 inNormal;  // octahedral
+layout(location = 3) in vec2 inTexCoord;
+layout(location = 4) in uvec4 inJointIndices;
+layout(location = 5) in vec4 inJointWeights;
+
+layout(push_constant) uniform PushConstants
+{
+    mat4 model;
+    vec4 baseColorFactor;
+    uint vertexStageFlag;
+    uint fragmentStageFlag;
+    uint jointOffset;
+    uint paletteStride;  // joints per instance
+};
+
+layout(set = 0, binding = 0) uniform Scene
+{
+    mat4 projection;
+    mat4 view;
+};
+
+// 0: linear blending of a matrix per joint, 1: a dual quaternion per joint
+layout(constant_id = 0) const uint skinningMethod = 0u;
+
+// matrices or dual quaternions depending on skinningMethod, one palette per instance
+layout(set = 2, binding = 0) readonly buffer JointPalette
+{
+    vec4 palette[];
+};
+
+// translation per instance
+layout(set = 2, binding = 1) readonly buffer Placements
+{
+    vec4 placements[];
+};
+
+// output =======================================
+layout(location = 0) out vec2 outTexCoord;
+layout(location = 1) out vec3 outColor;
+layout(location = 2) out vec3 outNormal;
+layout(location = 3) out vec3 outViewVec;
+layout(location = 4) out vec3 outLightVec;
+
+#include "octahedral.glsl"
+#include "skinning.glsl"
+
+void main()
+{
+    // pass on
+    outTexCoord = inTexCoord;
+    outColor    = vec3(1.0f, 1.0f, 1.0f);
+
+    // skinning, the palette of the instance
+    Skin skin  = blendJoints(uint(gl_InstanceIndex) * paletteStride + jointOffset, inJointIndices, inJointWeights);
+    vec4 world = vec4(skinPosition(skin, inPosition), 1.0) * model;
+    world.xyz += placements[gl_InstanceIndex].xyz;
+    gl_Position = world * view * projection;
+
+    // light
+    vec4 lightPosition = vec4(5.0f, 5.0f, 5.0f, 1.0f);
+    outNormal          = inverse(mat3(model * view)) * skinNormal(skin, decodeOctahedral(inNormal));
+    vec4 pos           = vec4(inPosition, 1.0) * view;
+    outLightVec        = lightPosition.xyz * mat3(view) - pos.xyz;
+    outViewVec         = -pos.xyz;
+}
\ No newline at end of file
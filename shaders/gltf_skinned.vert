@@ -0,0 +1,46 @@
+#version 450
+
+// input ========================================
+// position and normal are skinned by skinning.comp
+layout(location = 0) in vec3 inPosition;
+layout(location = 2) in vec3 inNormal;
+layout(location = 3) in vec2 inTexCoord;
+
+layout(push_constant) uniform PushConstants
+{
+    mat4 model;
+    vec4 baseColorFactor;
+    uint vertexStageFlag;
+    uint fragmentStageFlag;
+};
+
+layout(set = 0, binding = 0) uniform Scene
+{
+    mat4 projection;
+    mat4 view;
+};
+
+// output =======================================
+layout(location = 0) out vec2 outTexCoord;
+layout(location = 1) out vec3 outColor;
+layout(location = 2) out vec3 outNormal;
+layout(location = 3) out vec3 outViewVec;
+layout(location = 4) out vec3 outLightVec;
+// as in depth.vert
+invariant gl_Position;
+
+void main()
+{
+    // pass on
+    outTexCoord = inTexCoord;
+    outColor    = vec3(1.0f, 1.0f, 1.0f);
+
+    gl_Position = vec4(inPosition, 1.0) * model * view * projection;
+
+    // light
+    vec4 lightPosition = vec4(5.0f, 5.0f, 5.0f, 1.0f);
+    outNormal          = inverse(mat3(model * view)) * inNormal;
+    vec4 pos           = vec4(inPosition, 1.0) * view;
+    outLightVec        = lightPosition.xyz * mat3(view) - pos.xyz;
+    outViewVec         = -pos.xyz;
+}
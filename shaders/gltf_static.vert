@@ -1,12 +1,11 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 // input ========================================
+// the locations of GltfAsset::Vertex, static assets having no joints
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec3 inNormal;
+layout(location = 2) in vec2 inNormal;  // octahedral
 layout(location = 3) in vec2 inTexCoord;
-layout(location = 4) in vec4 inJointIndices;
-layout(location = 5) in vec4 inJointWeights;
 
 layout(push_constant) uniform PushConstants
 {
@@ -26,6 +25,10 @@ layout(set = 0, binding = 0) uniform Scene
 layout(location = 0) out vec2 fragTexCoord;
 layout(location = 1) out vec3 fragColor;
 layout(location = 2) out vec3 fragNormal;
+// as in depth.vert
+invariant gl_Position;
+
+#include "octahedral.glsl"
 
 void main()
 {
@@ -33,5 +36,5 @@ void main()
     // gl_Position  = projection * view * transpose(model) * vec4(inPosition, 1.0);
     fragTexCoord = inTexCoord;
     fragColor    = baseColorFactor.rgb;
-    fragNormal   = inNormal;
+    fragNormal   = decodeOctahedral(inNormal);
 }
\ No newline at end of file
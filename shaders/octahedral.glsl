@@ -0,0 +1,8 @@
+// the octahedral encoding of the asset normals, see geometry/quantize.hpp
+vec3 decodeOctahedral(vec2 encoded)
+{
+    vec3  normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold   = max(-normal.z, 0.0);
+    normal.xy += vec2(normal.x >= 0.0 ? -fold : fold, normal.y >= 0.0 ? -fold : fold);
+    return normalize(normal);
+}
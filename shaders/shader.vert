@@ -23,6 +23,8 @@ layout(set = 0, binding = 0) uniform Scene
 layout(location = 0) out vec2 fragTexCoord;
 layout(location = 1) out vec3 fragColor;
 layout(location = 2) out vec3 fragNormal;
+// as in depth.vert
+invariant gl_Position;
 
 
 void main()
@@ -0,0 +1,69 @@
+// shared by the shaders that skin vertices, after they declare skinningMethod and the palette buffer
+
+// the transform blended for a vertex: with linear blending the transposed matrix, as the joint palette holds matrices
+// read row by row; with dual quaternions the unit rotation and the translation, applied without building a matrix
+struct Skin
+{
+    mat4 matrix;
+    vec4 rotation;
+    vec3 translation;
+};
+
+Skin blendJoints(uint offset, uvec4 jointIndices, vec4 jointWeights)
+{
+    Skin  skin   = Skin(mat4(0.0), vec4(0.0), vec3(0.0));
+    uvec4 joints = uvec4(offset) + jointIndices;
+    if (skinningMethod == 0u)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            uint base = 4u * joints[i];
+            skin.matrix +=
+                jointWeights[i] * mat4(palette[base], palette[base + 1u], palette[base + 2u], palette[base + 3u]);
+        }
+        return skin;
+    }
+
+    // dual quaternions, blended in the hemisphere of the first joint and normalized
+    vec4 firstReal = palette[2u * joints.x];
+    vec4 real      = vec4(0.0);
+    vec4 dual      = vec4(0.0);
+    for (int i = 0; i < 4; ++i)
+    {
+        uint  base   = 2u * joints[i];
+        float weight = dot(palette[base], firstReal) < 0.0 ? -jointWeights[i] : jointWeights[i];
+        real += weight * palette[base];
+        dual += weight * palette[base + 1u];
+    }
+    float len = length(real);
+    real /= len;
+    dual /= len;
+
+    skin.rotation    = real;
+    skin.translation = 2.0 * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+    return skin;
+}
+
+vec3 rotate(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+vec3 skinPosition(Skin skin, vec3 position)
+{
+    if (skinningMethod == 0u)
+    {
+        return (vec4(position, 1.0) * skin.matrix).xyz;
+    }
+    return rotate(skin.rotation, position) + skin.translation;
+}
+
+// in the space of the skinned positions, not normalized
+vec3 skinNormal(Skin skin, vec3 normal)
+{
+    if (skinningMethod == 0u)
+    {
+        return inverse(mat3(skin.matrix)) * normal;
+    }
+    return rotate(skin.rotation, normal);
+}